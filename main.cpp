@@ -44,6 +44,12 @@
 #include "BluetoothSerial.h"
 #endif
 #include <stdint.h>
+#if defined(ESP32)
+#include <esp_timer.h>
+#include "src/clock.h"
+// Platform clock behind Clock::nowUs(), shared by the UART receive callback and the render loop
+uint64_t Clock::platformMicros() { return (uint64_t)esp_timer_get_time(); }
+#endif
 #else
 // Host (non-Arduino) build: provide minimal stubs so the file can be compiled/run locally
 #include <cstdint>
@@ -52,6 +58,12 @@
 #include <cstdarg>
 #include <thread>
 
+// Host builds exercise the transport code paths; sends are captured by the
+// SerialBT stub below instead of going over the air.
+#if !defined(ENABLE_REMOTE_TRANSPORTS)
+#define ENABLE_REMOTE_TRANSPORTS 1
+#endif
+
 struct DummySerial {
     void begin(int) {}
     /* allow non-literal format strings in host print/printf stubs */
@@ -70,37 +82,42 @@ DummySerial Serial;
 #include <deque>
 #include <vector>
 #include <array>
+#include <mutex>
 
 // Implementations for host stubs declared in src/host_stubs.h
 // HostSerial2
+// Guarded by a mutex so tests can push bytes while the host ingest thread reads.
 static std::deque<uint8_t> __host_serial2_q;
+static std::mutex __host_serial2_mu;
 void HostSerial2::begin(int, int, int, int) {}
-int HostSerial2::available() { return (int)__host_serial2_q.size(); }
-uint8_t HostSerial2::read() { uint8_t v = 0; if (!__host_serial2_q.empty()) { v = __host_serial2_q.front(); __host_serial2_q.pop_front(); } return v; }
-void HostSerial2::push(uint8_t b) { __host_serial2_q.push_back(b); }
-void HostSerial2::push(const std::vector<uint8_t>& bytes) { for (auto b: bytes) __host_serial2_q.push_back(b); }
+int HostSerial2::available() { std::lock_guard<std::mutex> lk(__host_serial2_mu); return (int)__host_serial2_q.size(); }
+uint8_t HostSerial2::read() { std::lock_guard<std::mutex> lk(__host_serial2_mu); uint8_t v = 0; if (!__host_serial2_q.empty()) { v = __host_serial2_q.front(); __host_serial2_q.pop_front(); } return v; }
+void HostSerial2::push(uint8_t b) { std::lock_guard<std::mutex> lk(__host_serial2_mu); __host_serial2_q.push_back(b); }
+void HostSerial2::push(const std::vector<uint8_t>& bytes) { std::lock_guard<std::mutex> lk(__host_serial2_mu); for (auto b: bytes) __host_serial2_q.push_back(b); }
 HostSerial2 Serial2;
 
 // HostBT
-static std::vector<std::array<uint8_t,5>> __host_bt_captured;
+static std::vector<std::vector<uint8_t>> __host_bt_captured;
 bool HostBT::begin(const char* name) { std::printf("(host) Simulated BT start: %s\n", name); return true; }
 size_t HostBT::write(const uint8_t* buf, size_t n) {
-    std::array<uint8_t,5> pkt = {0,0,0,0,0};
-    for (size_t i = 0; i < n && i < pkt.size(); ++i) pkt[i] = buf[i];
-    __host_bt_captured.push_back(pkt);
+    __host_bt_captured.emplace_back(buf, buf + n);
     std::printf("(host) BT packet (%zu bytes) captured\n", n);
     return n;
 }
-const std::vector<std::array<uint8_t,5>>& HostBT::getCaptured() const { return __host_bt_captured; }
+const std::vector<std::vector<uint8_t>>& HostBT::getCaptured() const { return __host_bt_captured; }
 void HostBT::clear() { __host_bt_captured.clear(); }
 HostBT SerialBT;
 
-// millis() stub for host
-uint32_t millis() {
+// Platform clock for host builds, counting from the first call. Firmware code
+// reads it through Clock::nowUs() so tests can substitute a virtual clock.
+#include "src/clock.h"
+uint64_t Clock::platformMicros() {
     static auto start = std::chrono::steady_clock::now();
     auto now = std::chrono::steady_clock::now();
-    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
 }
+// millis() stub for host, following the (possibly virtual) Clock
+uint32_t millis() { return Clock::nowMs(); }
 #endif
 
 #if !defined(ESP32) && !defined(TEST_RUNNER)
@@ -135,7 +152,9 @@ int main() {
         Serial.printf("(host) Captured %zu packets\n", captured.size());
         for (size_t i = 0; i < captured.size(); ++i) {
             const auto& pkt = captured[i];
-            Serial.printf("(host) pkt %zu: %u %u %u %u %u\n", i, pkt[0], pkt[1], pkt[2], pkt[3], pkt[4]);
+            Serial.printf("(host) pkt %zu:", i);
+            for (uint8_t b : pkt) Serial.printf(" %u", b);
+            Serial.printf("\n");
         }
     } catch (...) {
         Serial.println("(host) No captured packets or SerialBT unavailable");
@@ -145,6 +164,14 @@ int main() {
 #endif
 
 #include "src/teachtiles.h"
+#include "src/wire_protocol.h"
+#include "src/spsc_queue.h"
+#include "src/midi_parser.h"
+#include "src/log_ring.h"
+#include "src/note_tables.h"
+#include "src/loop_load.h"
+#include "src/overlay_asset.h"
+#include "src/asset_partition.h"
 
 // Allow disabling the Monalith display subsystem to shrink firmware size for
 // tests that don't require the HUB75 panel. Set ENABLE_MONALITH to 1 to
@@ -164,12 +191,17 @@ namespace Monalith {
     // Minimal enum matching the real API so callers like Monalith::DisplayState::StaticBitmap
     // compile when the full visualizer is disabled.
     enum class DisplayState : uint8_t { StaticBitmap = 0, Normal = 1 };
+    constexpr uint32_t DURATION_HELD = 0xFFFFFFFFu;
     inline bool init() { return true; }
-    inline void showNote(uint8_t /*note*/, uint32_t /*duration*/) {}
+    inline void showNote(uint8_t /*note*/, uint32_t /*duration*/, uint8_t /*velocity*/ = 100) {}
+    inline void releaseNote(uint8_t /*note*/) {}
     inline void showStaticBitmap(const uint16_t* /*bmp*/) {}
+    inline bool showStaticOverlay(const OverlayAsset& /*overlay*/) { return true; }
     inline void setDisplayState(DisplayState /*s*/) {}
     inline void clearStaticBitmap() {}
     inline void tick() {}
+    inline const char* backendName() { return "none"; }
+    inline uint32_t firstNoteMs() { return 0; }
 }
 #endif
 
@@ -189,12 +221,8 @@ uint8_t espnow_peer_mac[6] = {0,0,0,0,0,0};
 TransportMode transport = TM_UDP;
 
 void onDataRecv(const esp_now_recv_info_t* info, const uint8_t *data, int len) {
-    if (len < 5) return;
-    uint8_t note = data[0];
-    uint32_t duration = ((uint32_t)data[1]<<24) | ((uint32_t)data[2]<<16) | ((uint32_t)data[3]<<8) | (uint32_t)data[4];
-    Serial.printf("(ESP-NOW RX) Note: %s (%d) | Duration: %lu ms\n", midiNoteToName(note), note, duration);
-    // Forward to visualizer
-    Monalith::showNote(note, duration);
+    if (len <= 0) return;
+    handleRemotePacket(data, (size_t)len, TM_ESPNOW, "ESP-NOW RX");
 }
 
 void initEspNow() {
@@ -247,6 +275,9 @@ const char* ssid = "TeachTiles";
 const char* password = "TeachTiles2026";
 const char* router_ip = "192.168.1.100"; // Change to your router's IP
 const uint16_t router_port __attribute__((unused)) = 5005;
+// Stream NoteOn/NoteOff as they are parsed so receiving tiles light on press.
+// Set to WM_LEGACY_DURATION to talk to tiles still running the 5-byte format.
+WireMode wireMode = WM_STREAM_EVENTS;
 #endif
 
 // MIDI UART config (defined in src/teachtiles.h)
@@ -265,12 +296,18 @@ BluetoothSerial SerialBT;
 #define SERIAL_8N1 0
 #endif
 
-// MIDI message parsing state (type defined in header)
-MidiParseState midiState = WAIT_STATUS;
-uint8_t midiStatus = 0;
-uint8_t midiNote = 0;
-// Array to store note-on timestamps for each MIDI note (0-127)
-uint32_t noteOnTime[128] = {0};
+// Per-input MIDI context. The parser (running status, real-time interleave,
+// SysEx skip) is only touched by the ingest side and the note-on table only by
+// the render loop.
+struct MidiInputContext {
+    Midi::Parser parser;
+    // Note-on timestamps for each MIDI note (0-127) in microseconds; 64-bit so
+    // they never wrap (the old 32-bit millis() stamps wrapped after 49 days)
+    uint64_t noteOnTime[128];
+};
+MidiInputContext midiInputs[MIDI_SOURCE_COUNT] = {};
+// Unit for durations in streamed frames; legacy 5-byte packets are always ms
+DurationUnit durationUnit = DU_MS;
 // Track signal presence and current playing note for serial output
 uint32_t lastReceivedMillis = 0;
 bool signalPresent = false;
@@ -287,137 +324,342 @@ size_t rawBufLen = 0;
 int lastRxPinState = -1;
 // Pin check timing
 uint32_t lastPinCheckMillis = 0;
+// CPU left for loop() next to the display driver, reported every LOOP_LOAD_REPORT_MS
+LoopLoad loopLoad;
+// Clock time at which setup() returned; logged with the first note shown after boot
+uint32_t setupDoneMs = 0;
+bool bootTimeReported = false;
+
+// Parsed note events travel from the ingest task to the render loop through this ring
+SpscQueue<MidiEvent, MIDI_EVENT_QUEUE_LEN> midiEventQueue;
+// True while a dedicated ingest task/thread owns the MIDI inputs
+static std::atomic<bool> midiIngestRunning{false};
+
+// Producer side: parse one MIDI byte, timestamp completed note messages and
+// queue them for the render loop.
+void processMidiByte(uint8_t byte, uint64_t t_us, uint8_t source) {
+    if (source >= MIDI_SOURCE_COUNT) return;
+    // The raw dump buffer is owned by loop(), so only capture when parsing inline
+    if (!midiIngestRunning.load(std::memory_order_relaxed) && rawBufLen < sizeof(rawBuf)) rawBuf[rawBufLen++] = byte;
+
+    Midi::Message msg;
+    if (!midiInputs[source].parser.push(byte, msg)) return;
+    // Only notes drive the tiles; CC, pitch bend, aftertouch and real-time are parsed but not queued
+    if (!msg.isNote()) return;
+    // Stamp with the arrival time of the byte that completed the message
+    MidiEvent ev{ (uint8_t)((msg.type == Midi::MSG_NOTE_ON ? 0x90 : 0x80) | msg.channel), msg.data1, msg.data2, source, t_us };
+    // A full ring means loop() stalled: push() fails and counts the event in
+    // dropped(), which the next drainMidiEvents() reports
+    (void)midiEventQueue.push(ev);
+}
 
-void processMidiByte(uint8_t byte) {
-    if (rawBufLen < sizeof(rawBuf)) rawBuf[rawBufLen++] = byte;
-
-    // MIDI message parsing (only note-on and note-off)
-    if (byte & 0x80) {
-        midiStatus = byte;
-        midiState = WAIT_NOTE;
-        return;
+// Consumer side: track note-on times and send/print the event.
+void handleMidiEvent(const MidiEvent& ev) {
+    uint8_t note = ev.note;
+    uint64_t* noteOnTime = midiInputs[ev.source].noteOnTime;
+    lastReceivedMillis = (uint32_t)(ev.time_us / 1000);
+    signalPresent = true;
+
+    if ((ev.status & 0xF0) == 0x90 && ev.velocity > 0) {
+        uint64_t t = ev.time_us;
+        if (t == 0) t = 1;
+        noteOnTime[note] = t;
+        currentPlayingNote = note;
+        currentVelocityVal = ev.velocity;
+        currentNoteStart = (uint32_t)(t / 1000);
+        LOG_INFO(LF_NOTE_ON, note, note, currentVelocityVal);
+        if (wireMode == WM_STREAM_EVENTS) sendNoteEvent(0x90, note, currentVelocityVal, 0, ev.source, (uint32_t)(ev.time_us / 1000));
+    } else {
+        uint64_t durationUs = 0;
+        if (noteOnTime[note] != 0) {
+            durationUs = ev.time_us - noteOnTime[note];
+            if (durationUs == 0) durationUs = 1;
+        }
+        LOG_INFO(LF_NOTE_OFF, note, note, ev.velocity, (uint32_t)(durationUs / 1000), (uint32_t)(durationUs % 1000));
+        if (noteOnTime[note] != 0) {
+            if (wireMode == WM_STREAM_EVENTS) sendNoteEvent(0x80, note, ev.velocity, durationToUnit(durationUs, durationUnit), ev.source, (uint32_t)(ev.time_us / 1000));
+            else sendNoteData(note, durationToUnit(durationUs, DU_MS));
+        } else {
+            LOG_INFO(LF_OFF_WITHOUT_ON, note);
+        }
+        noteOnTime[note] = 0;
+        if (currentPlayingNote == note) {
+            currentPlayingNote = -1;
+            currentVelocityVal = 0;
+            currentNoteStart = 0;
+        }
     }
+}
 
-    switch (midiState) {
-        case WAIT_NOTE:
-            midiNote = byte;
-            midiState = WAIT_VELOCITY;
-            break;
-        case WAIT_VELOCITY:
-            lastReceivedMillis = millis();
-            signalPresent = true;
-
-            if ((midiStatus & 0xF0) == 0x90 && byte > 0) {
-                uint32_t t = millis();
-                if (t == 0) t = 1;
-                noteOnTime[midiNote] = t;
-                currentPlayingNote = midiNote;
-                currentVelocityVal = byte;
-                currentNoteStart = noteOnTime[midiNote];
-                Serial.printf("Signal: true | Note: %s (%d) | Velocity: %d | State: ON\n", midiNoteToName(midiNote), midiNote, currentVelocityVal);
-            } else if (((midiStatus & 0xF0) == 0x80) || ((midiStatus & 0xF0) == 0x90 && byte == 0)) {
-                uint32_t now = millis();
-                uint32_t duration = 0;
-                if (noteOnTime[midiNote] != 0) {
-                    duration = now - noteOnTime[midiNote];
-                    if (duration == 0) duration = 1;
-                }
-                Serial.printf("Signal: true | Note: %s (%d) | Velocity: %d | State: OFF | Duration: %lu ms\n", midiNoteToName(midiNote), midiNote, (unsigned)byte, duration);
-                if (noteOnTime[midiNote] != 0) {
-                    sendNoteData(midiNote, duration);
-                } else {
-                    Serial.printf("(info) Ignored OFF for note %d with no prior ON\n", midiNote);
-                }
-                noteOnTime[midiNote] = 0;
-                if (currentPlayingNote == midiNote) {
-                    currentPlayingNote = -1;
-                    currentVelocityVal = 0;
-                    currentNoteStart = 0;
-                }
-            }
-            midiState = WAIT_NOTE;
-            break;
-        default:
-            midiState = WAIT_STATUS;
-            break;
+// Drain every queued event; called from the render loop. Inputs are read in
+// turn, so a batch can hold events from different sources out of time order;
+// a stable insertion sort merges them into one stream ordered by timestamp.
+void drainMidiEvents() {
+    // Lost note-offs leave notes held on the tiles, so drops are always reported
+    static uint32_t reportedDrops = 0;
+    uint32_t drops = midiEventQueue.dropped();
+    if (drops != reportedDrops) {
+        LOG_WARN(LF_MIDI_DROPPED, drops - reportedDrops, drops);
+        reportedDrops = drops;
     }
+    MidiEvent batch[MIDI_EVENT_QUEUE_LEN];
+    size_t n;
+    do {
+        n = 0;
+        MidiEvent ev;
+        while (n < MIDI_EVENT_QUEUE_LEN && midiEventQueue.pop(ev)) {
+            size_t i = n++;
+            while (i > 0 && batch[i - 1].time_us > ev.time_us) { batch[i] = batch[i - 1]; --i; }
+            batch[i] = ev;
+        }
+        for (size_t i = 0; i < n; ++i) handleMidiEvent(batch[i]);
+    } while (n == MIDI_EVENT_QUEUE_LEN);
 }
 
+// Inline polling path (host, or ESP32 before the ingest task starts): bytes are
+// stamped when read, so resolution depends on how often this runs.
 void processIncomingMidi() {
     while (Serial2.available()) {
-        processMidiByte(Serial2.read());
+        processMidiByte(Serial2.read(), Clock::nowUs(), MS_DIN);
     }
 
 #if defined(ESP32)
     // Raspberry Pi bridge writes raw MIDI bytes over the ESP32 USB serial port.
     while (Serial.available()) {
-        processMidiByte((uint8_t)Serial.read());
+        processMidiByte((uint8_t)Serial.read(), Clock::nowUs(), MS_USB);
     }
 #endif
 }
 
-// Helper: convert MIDI note number to note name (e.g., 60 -> C4)
-const char* midiNoteToName(uint8_t note) {
-    static char buf[8];
-    static const char* names[] = {"C","C#","D","D#","E","F","F#","G","G#","A","A#","B"};
-    int n = note % 12;
-    int octave = (note / 12) - 1; // MIDI octave numbering
-    snprintf(buf, sizeof(buf), "%s%d", names[n], octave);
-    return buf;
+// Dedicated ingest task: drains the MIDI inputs and timestamps events so a slow
+// panel refresh in loop() cannot delay them. Pinned to core 0; loop() runs on core 1.
+#if defined(ESP32)
+// DIN MIDI bytes stamped in the Serial2 receive callback, consumed by the ingest task
+static SpscQueue<StampedByte, 256> uartRxQueue;
+static TaskHandle_t midiIngestHandle = nullptr;
+
+// Runs in the UART event task as soon as the RX FIFO threshold (1 byte) or the
+// RX timeout fires. Bytes already waiting in the FIFO arrived earlier, so each
+// is back-dated by one MIDI byte time per byte that followed it.
+static void onMidiUartReceive() {
+    uint64_t now = Clock::nowUs();
+    int n = Serial2.available();
+    for (int i = 0; i < n; ++i) {
+        StampedByte sb{ (uint8_t)Serial2.read(), now - (uint64_t)(n - 1 - i) * MIDI_BYTE_US };
+        uartRxQueue.push(sb);
+    }
+    if (midiIngestHandle) xTaskNotifyGive(midiIngestHandle);
+}
+
+static void midiIngestTask(void*) {
+    for (;;) {
+        // Wake immediately on UART RX; the timeout keeps the USB bridge polled
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MIDI_USB_POLL_MS));
+        StampedByte sb;
+        while (uartRxQueue.pop(sb)) processMidiByte(sb.byte, sb.time_us, MS_DIN);
+        // Raspberry Pi bridge writes raw MIDI bytes over the ESP32 USB serial port.
+        while (Serial.available()) processMidiByte((uint8_t)Serial.read(), Clock::nowUs(), MS_USB);
+    }
+}
+
+bool startMidiIngestTask() {
+    if (midiIngestRunning) return true;
+    midiIngestRunning = true;
+    if (xTaskCreatePinnedToCore(midiIngestTask, "midi_ingest", 4096, nullptr, MIDI_INGEST_TASK_PRIORITY, &midiIngestHandle, 0) != pdPASS) {
+        midiIngestRunning = false;
+        Serial.println("Failed to start MIDI ingest task; parsing inline in loop()");
+        return false;
+    }
+    // Interrupt on every received byte and after one idle symbol so bytes are
+    // stamped on arrival rather than whenever loop() happens to poll.
+    Serial2.setRxFIFOFull(1);
+    Serial2.setRxTimeout(1);
+    Serial2.onReceive(onMidiUartReceive);
+    return true;
+}
+#else
+// Host build of the ingest task: a std::thread polling the Serial2 stub
+static std::thread midiIngestThread;
+
+bool startMidiIngestTask() {
+    if (midiIngestRunning) return true;
+    midiIngestRunning = true;
+    midiIngestThread = std::thread([] {
+        while (midiIngestRunning.load()) {
+            processIncomingMidi();
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+    return true;
+}
+
+void stopMidiIngestTask() {
+    if (!midiIngestRunning) return;
+    midiIngestRunning = false;
+    if (midiIngestThread.joinable()) midiIngestThread.join();
 }
-void sendNoteData(uint8_t note, uint32_t duration) {
-#if defined(ESP32) && !ENABLE_REMOTE_TRANSPORTS
-    Monalith::showNote(note, duration);
-    return;
 #endif
 
-    // Package: [note, duration (ms, 4 bytes)]
-    uint8_t packet[5];
-    packet[0] = note;
-    // pack big-endian (MSB first) — tests expect p[1]<<24 ... p[4]
-    packet[1] = (duration >> 24) & 0xFF;
-    packet[2] = (duration >> 16) & 0xFF;
-    packet[3] = (duration >> 8) & 0xFF;
-    packet[4] = duration & 0xFF;
-    // Send via selected transport
+// Write deferred log records to the debug serial port
+static size_t flushLog() {
+    return Log::flush([](const char* line) { Serial.println(line); });
+}
+
+#if defined(ESP32)
+// Formats log records off the hot path. Runs at idle priority on core 0, so it
+// only gets the CPU when the ingest and radio tasks there are blocked.
+static void logFlushTask(void*) {
+    for (;;) {
+        flushLog();
+        vTaskDelay(pdMS_TO_TICKS(LOG_FLUSH_INTERVAL_MS));
+    }
+}
+#endif
+
+// Helper: convert MIDI note number to note name (e.g., 60 -> C4). Returns a
+// pointer into a constant table, so it is safe to call from any task.
+const char* midiNoteToName(uint8_t note) {
+    return NoteTables::NAME[note].s;
+}
+// Send one packet to the remote tile over the selected transport.
+static void sendPacket(const uint8_t* packet, size_t len) {
     // If Bluetooth is enabled and a client is connected, send via SPP
     if (transport == TM_BT) {
 #if USE_BT
     if (SerialBT.hasClient()) {
-        SerialBT.write(packet, 5);
+        SerialBT.write(packet, len);
     } else {
-        Serial.printf("(bt) no client connected; would send note %d dur %lu\n", packet[0], (unsigned long)duration);
+        LOG_WARN(LF_TX_NO_PEER, "bt", len);
     }
 #else
-    Serial.printf("(bt disabled) would send packet for note %d dur %lu\n", packet[0], (unsigned long)duration);
+    LOG_WARN(LF_TX_NO_PEER, "bt disabled", len);
 #endif
 #if ENABLE_REMOTE_TRANSPORTS
     } else if (transport == TM_ESPNOW) {
 #if defined(ESP32)
         if (memcmp(espnow_peer_mac, (uint8_t[]){0,0,0,0,0,0}, 6) != 0) {
-            esp_err_t r = esp_now_send(espnow_peer_mac, packet, 5);
-            if (r != ESP_OK) Serial.printf("ESP-NOW send er ror: %d\n", r);
+            esp_err_t r = esp_now_send(espnow_peer_mac, packet, len);
+            if (r != ESP_OK) LOG_ERROR(LF_TX_ERROR, (int32_t)r);
         } else {
-            Serial.println("ESP-NOW peer not configured; cannot send");
+            LOG_WARN(LF_TX_NO_PEER, "ESP-NOW", len);
         }
 #else
         // Host: fall back to SerialBT
-        SerialBT.write(packet, 5);
+        SerialBT.write(packet, len);
 #endif
     } else if (transport == TM_UDP) {
 #if defined(ESP32)
         _udp.beginPacket(router_ip, router_port);
-        _udp.write(packet, 5);
+        _udp.write(packet, len);
         _udp.endPacket();
 #else
         // Host fallback: SerialBT captures
-        SerialBT.write(packet, 5);
+        SerialBT.write(packet, len);
 #endif
     #endif
     }
 }
+
+void sendNoteData(uint8_t note, uint32_t duration) {
+#if defined(ESP32) && !ENABLE_REMOTE_TRANSPORTS
+    Monalith::showNote(note, duration);
+    return;
+#endif
+
+    // Package: [note, duration (ms, 4 bytes)]
+    uint8_t packet[5];
+    packet[0] = note;
+    // pack big-endian (MSB first) — tests expect p[1]<<24 ... p[4]
+    packet[1] = (duration >> 24) & 0xFF;
+    packet[2] = (duration >> 16) & 0xFF;
+    packet[3] = (duration >> 8) & 0xFF;
+    packet[4] = duration & 0xFF;
+    sendPacket(packet, sizeof(packet));
+}
+
+// Pending streamed events; flushed as one v2 frame per coalescing window
+static WireProtocol::FrameBatcher txBatch;
+
+void flushNoteEvents(bool force) {
+    if (txBatch.count == 0) return;
+    if (!force && !txBatch.due(Clock::nowMs(), WIRE_COALESCE_MS)) return;
+    uint8_t frame[WireProtocol::MAX_FRAME_BYTES];
+    size_t len = txBatch.flush(frame, sizeof(frame));
+    if (len) sendPacket(frame, len);
+}
+
+void sendNoteEvent(uint8_t status, uint8_t note, uint8_t velocity, uint32_t duration, uint8_t source, uint32_t time_ms) {
+#if defined(ESP32) && !ENABLE_REMOTE_TRANSPORTS
+    if (status == 0x90) Monalith::showNote(note, Monalith::DURATION_HELD, velocity);
+    else Monalith::releaseNote(note);
+    return;
+#endif
+
+    WireProtocol::Event ev{};
+    ev.type = status == 0x90 ? WireProtocol::EV_NOTE_ON : WireProtocol::EV_NOTE_OFF;
+    ev.note = note;
+    ev.velocity = velocity;
+    ev.source = source;
+    ev.time_ms = time_ms ? time_ms : Clock::nowMs();
+    ev.duration = duration;
+    txBatch.flags = durationUnit == DU_US ? WireProtocol::FLAG_DURATION_US : 0;
+    if (txBatch.add(ev)) flushNoteEvents(true);
+}
+
+// Receive-side loss/reorder tracking for v2 frames, one per transport since
+// each link has its own sender and sequence
+static WireProtocol::SeqTracker rxSeqs[3];
+
+// Decode a packet received from another tile and forward it to the visualizer.
+// Accepts v2 frames as well as the v1 3-byte events and legacy 5-byte packets.
+void handleRemotePacket(const uint8_t* buf, size_t len, TransportMode from, const char* tag) {
+    (void)tag; // only referenced by log records, which may be compiled out
+    WireProtocol::FrameHeader h;
+    WireProtocol::Event events[WireProtocol::MAX_EVENTS];
+    size_t n = WireProtocol::decodePacket(buf, len, h, events, WireProtocol::MAX_EVENTS);
+    if (n == 0) {
+        LOG_WARN(LF_RX_MALFORMED, tag, len);
+        return;
+    }
+    if (h.version == WireProtocol::VERSION) {
+        WireProtocol::SeqTracker& rxSeq = rxSeqs[from];
+        uint32_t lostBefore = rxSeq.lost, resyncsBefore = rxSeq.resyncs;
+        if (!rxSeq.accept(h.seq, Clock::nowMs())) {
+            LOG_WARN(LF_RX_STALE, tag, h.seq, rxSeq.reordered);
+            return;
+        }
+        if (rxSeq.resyncs != resyncsBefore) {
+            LOG_WARN(LF_RX_RESYNC, tag, h.seq, rxSeq.resyncs);
+        }
+        if (rxSeq.lost != lostBefore) {
+            LOG_WARN(LF_RX_LOST, tag, rxSeq.lost - lostBefore, h.seq);
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        const WireProtocol::Event& ev = events[i];
+        switch (ev.type) {
+            case WireProtocol::EV_NOTE_ON:
+                LOG_INFO(LF_RX_NOTE_ON, tag, ev.note, ev.note, ev.velocity);
+                Monalith::showNote(ev.note, Monalith::DURATION_HELD, ev.velocity);
+                break;
+            case WireProtocol::EV_NOTE_OFF:
+                LOG_INFO(LF_RX_NOTE_OFF, tag, ev.note, ev.note, WireProtocol::durationMs(h, ev));
+                Monalith::releaseNote(ev.note);
+                break;
+            case WireProtocol::EV_NOTE_DURATION:
+                LOG_INFO(LF_RX_NOTE_DURATION, tag, ev.note, ev.note, WireProtocol::durationMs(h, ev));
+                Monalith::showNote(ev.note, WireProtocol::durationMs(h, ev));
+                break;
+            default:
+                break;
+        }
+    }
+}
 void setup() {
     Serial.begin(115200); // Debug output
+#if defined(ESP32)
+    xTaskCreatePinnedToCore(logFlushTask, "log_flush", 4096, nullptr, tskIDLE_PRIORITY, nullptr, 0);
+#endif
     // Initialize MIDI RX and Bluetooth for both host tests and ESP32
     // Use explicit SERIAL_8N1 for MIDI UART config. If your MIDI interface inverts the signal
     // you may need to use SERIAL_8N1 (default) or invert wiring/driver. If you used a raw 3
@@ -484,8 +726,7 @@ void setup() {
     // Create a tiny on-stack white bitmap (RGB565 64x64 = 4096 uint16_t)
     static uint16_t white_bitmap[64*64];
     for (size_t i = 0; i < (64*64); ++i) white_bitmap[i] = 0xFFFF; // white in RGB565
-    // Use the standard static bitmap blit (may run a short diagnostic) which
-    // is guaranteed to be linked in.
+    // Use the standard static bitmap blit, which is guaranteed to be linked in.
     Monalith::showStaticBitmap(white_bitmap);
     Monalith::setDisplayState(Monalith::DisplayState::StaticBitmap);
     // Done: do not start WiFi/ESP-NOW/UDP/BT
@@ -493,10 +734,26 @@ void setup() {
 #else
     // Short visual test: flash example bitmap (normal operation)
 #if !defined(TEST_RUNNER)
-    extern const uint16_t example_bitmap[]; // defined in example_bitmap.c
-    Monalith::showStaticBitmap(example_bitmap);
+    // Boot overlay from the assets partition when one was uploaded, decoded
+    // straight from mapped flash; else the one built into the app
+    extern const OverlayAsset example_overlay; // defined in example_bitmap.c
+    static AssetBundle::View assets;
+    AssetBundle::Status assetStatus = AssetPartition::mount(assets);
+    OverlayAsset bootOverlay;
+    if (assetStatus == AssetBundle::OK) {
+        Serial.printf("Assets: %u overlay(s), %u bytes\n", (unsigned)assets.count(), (unsigned)assets.bytes());
+    } else {
+        Serial.printf("Assets: %s, using built-in overlay\n", AssetBundle::statusName(assetStatus));
+    }
+    if (!assets.find(ASSET_BOOT_OVERLAY, bootOverlay) || !Monalith::showStaticOverlay(bootOverlay)) {
+        Monalith::showStaticOverlay(example_overlay);
+    }
     Monalith::setDisplayState(Monalith::DisplayState::StaticBitmap);
 #endif
+#endif
+#if defined(ESP32)
+    // Parse MIDI on core 0 so panel refreshes in loop() cannot delay timestamps
+    startMidiIngestTask();
 #endif
     // Auto-clear the static bitmap after 60 seconds so the overlay is visible
     // for a measured period and then the display returns to normal behavior.
@@ -512,6 +769,7 @@ void setup() {
     // create a low-priority task to perform the delayed clear
     xTaskCreatePinnedToCore(clear_task, "clear_bitmap", 2048, nullptr, 1, nullptr, 1);
 #endif
+    setupDoneMs = Clock::nowMs();
 }
 
 void loop() {
@@ -523,17 +781,26 @@ void loop() {
     delay(1000);
     return;
 #endif
+    uint64_t loopStartUs = Clock::nowUs();
     // Read incoming bytes into rawBuf for optional hex dump
     rawBufLen = 0;
-    processIncomingMidi();
+    // Without the ingest task, parse inline; either way consume queued events here
+    if (!midiIngestRunning) processIncomingMidi();
+    drainMidiEvents();
+    // Send any streamed events whose coalescing window has elapsed
+    flushNoteEvents(false);
     // Dump raw MIDI bytes occasionally for debug if any were read
-    uint32_t now = millis();
+    uint32_t now = Clock::nowMs();
     if (rawBufLen > 0 && (now - lastRawDumpMillis) >= RAW_MIDI_DUMP_MS) {
-        Serial.print("Raw MIDI bytes: ");
-        for (size_t i = 0; i < rawBufLen; ++i) {
-            Serial.printf("%02X ", rawBuf[i]);
+#if TT_LOG_LEVEL <= TT_LOG_LEVEL_DEBUG
+        // Up to Log::MAX_ARGS bytes per record
+        for (size_t i = 0; i < rawBufLen; i += Log::MAX_ARGS) {
+            uint32_t bytes[Log::MAX_ARGS];
+            size_t n = 0;
+            for (; n < Log::MAX_ARGS && i + n < rawBufLen; ++n) bytes[n] = rawBuf[i + n];
+            LOG_DEBUG_ARGS(LF_RAW_MIDI, bytes, n);
         }
-    Serial.println("");
+#endif
         lastRawDumpMillis = now;
     }
     // No periodic status printing: updates are printed only when incoming MIDI events are parsed
@@ -547,11 +814,9 @@ void loop() {
     if ((now - lastStatusPrintMillis) >= STATUS_PRINT_INTERVAL_MS) {
         lastStatusPrintMillis = now;
         if (currentPlayingNote != -1) {
-            uint32_t playingFor = now - currentNoteStart;
-            Serial.printf("Playing: true | Note: %s (%d) | Velocity: %d | Playing for: %lums\n",
-                          midiNoteToName((uint8_t)currentPlayingNote), currentPlayingNote, currentVelocityVal, (unsigned long)playingFor);
+            LOG_INFO(LF_PLAYING, currentPlayingNote, currentPlayingNote, currentVelocityVal, now - currentNoteStart);
         } else {
-            Serial.println("Playing: false");
+            LOG_INFO(LF_NOT_PLAYING);
         }
     }
 
@@ -562,49 +827,53 @@ void loop() {
         int s = digitalRead(MIDI_RX_PIN);
         if (s != lastRxPinState) {
             lastRxPinState = s;
-            Serial.printf("RX pin state changed: %s\n", s ? "HIGH" : "LOW");
+            LOG_INFO(LF_RX_PIN, s ? "HIGH" : "LOW");
         }
     }
 #endif
 
 #if defined(ESP32)
 #if USE_BT && ENABLE_REMOTE_TRANSPORTS
-    // Check for incoming Bluetooth SPP packets (5-byte note packets)
+    // Check for incoming Bluetooth SPP packets; the framer splits the byte stream into packets
     if (SerialBT.hasClient()) {
-        while (SerialBT.available() >= 5) {
-            uint8_t buf[5];
-            size_t r = SerialBT.readBytes(buf, 5);
-            if (r == 5) {
-                uint8_t note = buf[0];
-                uint32_t duration = ((uint32_t)buf[1]<<24) | ((uint32_t)buf[2]<<16) | ((uint32_t)buf[3]<<8) | (uint32_t)buf[4];
-                Serial.printf("(BT RX) Note: %s (%d) | Duration: %lu ms\n", midiNoteToName(note), note, duration);
-                Monalith::showNote(note, duration);
-            }
+        static WireProtocol::StreamFramer btFramer;
+        while (SerialBT.available()) {
+            size_t n = btFramer.push((uint8_t)SerialBT.read());
+            if (n) handleRemotePacket(btFramer.buf, n, TM_BT, "BT RX");
         }
     }
 #endif
 #if defined(ESP32) && ENABLE_REMOTE_TRANSPORTS
-    // UDP receive: listen for 5-byte packets from the bridge/host
+    // UDP receive: listen for event/note packets from the bridge/host
     if (transport == TM_UDP) {
         int packetSize = _udp.parsePacket();
-        if (packetSize >= 5) {
-            uint8_t buf[5];
-            int len = _udp.read(buf, 5);
-            if (len == 5) {
-                uint8_t note = buf[0];
-                uint32_t duration = ((uint32_t)buf[1]<<24) | ((uint32_t)buf[2]<<16) | ((uint32_t)buf[3]<<8) | (uint32_t)buf[4];
-                Serial.printf("(UDP RX) Note: %s (%d) | Duration: %lu ms\n", midiNoteToName(note), note, duration);
-                // Forward to visualizer
-                Monalith::showNote(note, duration);
-            } else {
-                // drain the packet if it's larger/shorter to avoid re-reading
-                uint8_t drainBuf[64];
-                while (_udp.available()) _udp.read(drainBuf, sizeof(drainBuf));
-            }
+        if (packetSize >= 3) {
+            uint8_t buf[WireProtocol::MAX_FRAME_BYTES];
+            int len = _udp.read(buf, sizeof(buf));
+            if (len >= 3) handleRemotePacket(buf, (size_t)len, TM_UDP, "UDP RX");
+            // drain the rest of an oversized packet to avoid re-reading
+            uint8_t drainBuf[64];
+            while (_udp.available()) _udp.read(drainBuf, sizeof(drainBuf));
         }
     }
 #endif
 #endif
     // Advance visualizer animations
+    uint64_t tickStartUs = Clock::nowUs();
     Monalith::tick();
+    uint64_t loopEndUs = Clock::nowUs();
+    loopLoad.add((uint32_t)(loopEndUs - loopStartUs), (uint32_t)(loopEndUs - tickStartUs));
+    if (!bootTimeReported && Monalith::firstNoteMs() != 0) {
+        bootTimeReported = true;
+        LOG_INFO(LF_BOOT_FIRST_NOTE, Monalith::firstNoteMs(), setupDoneMs);
+    }
+    LoopLoad::Report load;
+    if (loopLoad.take(loopEndUs, (uint64_t)LOOP_LOAD_REPORT_MS * 1000, load)) {
+        LOG_INFO(LF_LOOP_LOAD, Monalith::backendName(), load.loopsPerSec, load.maxLoopUs,
+                 load.tickPermille / 10, load.tickPermille % 10, load.maxTickUs);
+    }
+#if !defined(ESP32)
+    // Host has no flush task; emit deferred log lines once per loop
+    flushLog();
+#endif
 }
\ No newline at end of file
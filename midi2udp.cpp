@@ -14,11 +14,13 @@
 #include <unistd.h>
 
 #include "RtMidi.h"
+#include "src/wire_protocol.h"
 
 using namespace std;
 static volatile bool running = true;
 void sigint_handler(int) { running = false; }
 
+// Legacy 5-byte [note, duration] packet for tiles running older firmware
 void send_packet(int sock, const sockaddr_in& addr, uint8_t note, uint32_t duration_ms) {
     uint8_t pkt[5];
     pkt[0] = note;
@@ -31,17 +33,38 @@ void send_packet(int sock, const sockaddr_in& addr, uint8_t note, uint32_t durat
     else cout << "SENT note=" << int(note) << " dur=" << duration_ms << " ms\n";
 }
 
+// Send the pending v2 batch as one frame
+void flush_batch(int sock, const sockaddr_in& addr, WireProtocol::FrameBatcher& batch) {
+    if (batch.count == 0) return;
+    size_t events = batch.count;
+    uint16_t seq = batch.seq;
+    uint8_t frame[WireProtocol::MAX_FRAME_BYTES];
+    size_t len = batch.flush(frame, sizeof(frame));
+    ssize_t r = sendto(sock, frame, len, 0, (const sockaddr*)&addr, sizeof(addr));
+    if (r < 0) perror("sendto");
+    else cout << "SENT frame seq=" << seq << " events=" << events << " (" << len << " bytes)\n";
+}
+
 int main(int argc, char** argv) {
     string addr_str = "255.255.255.255";
     int port = 5005;
     string device_arg;
+    bool legacy = false;
+    bool micros = false;
+    uint32_t coalesce_ms = 3;
     for (int i = 1; i < argc; ++i) {
         string a = argv[i];
         if (a == "--addr" && i+1 < argc) { addr_str = argv[++i]; continue; }
         if (a == "--port" && i+1 < argc) { port = stoi(argv[++i]); continue; }
         if (a == "--device" && i+1 < argc) { device_arg = argv[++i]; continue; }
+        if (a == "--legacy") { legacy = true; continue; }
+        if (a == "--us") { micros = true; continue; }
+        if (a == "--coalesce" && i+1 < argc) { coalesce_ms = (uint32_t)stoul(argv[++i]); continue; }
         if (a == "--help") {
-            cout << "Usage: midi2udp [--addr ADDR] [--port PORT] [--device name_or_index]\n";
+            cout << "Usage: midi2udp [--addr ADDR] [--port PORT] [--device name_or_index] [--legacy] [--us] [--coalesce MS]\n";
+            cout << "  --legacy       send 5-byte note+duration packets on release instead of v2 event frames\n";
+            cout << "  --us           send v2 note durations in microseconds instead of ms\n";
+            cout << "  --coalesce MS  batch events arriving within MS of each other into one frame (default 3)\n";
             return 0;
         }
     }
@@ -89,48 +112,55 @@ int main(int argc, char** argv) {
     midiin.ignoreTypes(false, false, false);
 
     unordered_map<int, uint64_t> note_on_time;
+    WireProtocol::FrameBatcher batch;
+    if (micros) batch.flags = WireProtocol::FLAG_DURATION_US;
 
-    cout << "Bridge running: sending to " << addr_str << ":" << port << ". Ctrl-C to exit." << endl;
+    cout << "Bridge running: sending " << (legacy ? "legacy packets" : "v2 frames") << " to " << addr_str << ":" << port << ". Ctrl-C to exit." << endl;
+
+    // Record a note-off: legacy mode sends the duration packet, v2 queues an event
+    auto note_off = [&](uint8_t note, uint8_t vel, uint64_t now_us) {
+        auto it = note_on_time.find(note);
+        if (it == note_on_time.end()) {
+            cout << "NOTE OFF (no prior ON) " << int(note) << "\n";
+            return;
+        }
+        uint64_t held_us = now_us - it->second;
+        note_on_time.erase(it);
+        uint32_t dur_ms = uint32_t((held_us + 500) / 1000);
+        uint32_t now_ms = uint32_t(now_us / 1000);
+        if (legacy) {
+            send_packet(sock, dst, note, dur_ms);
+        } else if (batch.add(WireProtocol::Event{ WireProtocol::EV_NOTE_OFF, note, vel, 0, now_ms, micros ? uint32_t(held_us) : dur_ms })) {
+            flush_batch(sock, dst, batch);
+        }
+    };
 
     while (running) {
         vector<unsigned char> message;
         double stamp = midiin.getMessage(&message);
+        (void)stamp;
+        uint64_t now_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+        uint32_t now_ms = uint32_t(now_us / 1000);
         if (!message.empty()) {
             uint8_t status = message[0] & 0xF0;
-            if (status == 0x90) {
-                uint8_t note = message.size() > 1 ? message[1] : 0;
-                uint8_t vel = message.size() > 2 ? message[2] : 0;
-                uint64_t now_ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
-                if (vel > 0) {
-                    note_on_time[note] = now_ms;
-                    cout << "NOTE ON " << int(note) << " vel=" << int(vel) << "\n";
-                } else {
-                    auto it = note_on_time.find(note);
-                    if (it != note_on_time.end()) {
-                        uint32_t dur = uint32_t(now_ms - it->second);
-                        send_packet(sock, dst, note, dur);
-                        note_on_time.erase(it);
-                    } else {
-                        cout << "NOTE OFF (no prior ON) " << int(note) << "\n";
-                    }
-                }
-            } else if (status == 0x80) {
-                uint8_t note = message.size() > 1 ? message[1] : 0;
-                uint64_t now_ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
-                auto it = note_on_time.find(note);
-                if (it != note_on_time.end()) {
-                    uint32_t dur = uint32_t(now_ms - it->second);
-                    send_packet(sock, dst, note, dur);
-                    note_on_time.erase(it);
-                } else {
-                    cout << "NOTE OFF (no prior ON) " << int(note) << "\n";
+            uint8_t note = message.size() > 1 ? message[1] : 0;
+            uint8_t vel = message.size() > 2 ? message[2] : 0;
+            if (status == 0x90 && vel > 0) {
+                note_on_time[note] = now_us;
+                cout << "NOTE ON " << int(note) << " vel=" << int(vel) << "\n";
+                if (!legacy && batch.add(WireProtocol::Event{ WireProtocol::EV_NOTE_ON, note, vel, 0, now_ms, 0 })) {
+                    flush_batch(sock, dst, batch);
                 }
+            } else if (status == 0x90 || status == 0x80) {
+                note_off(note, vel, now_us);
             }
-        } else {
-            this_thread::sleep_for(chrono::milliseconds(1));
+            continue; // drain queued messages before sleeping so chords share a frame
         }
+        if (batch.due(now_ms, coalesce_ms)) flush_batch(sock, dst, batch);
+        this_thread::sleep_for(chrono::milliseconds(1));
     }
 
+    flush_batch(sock, dst, batch);
     close(sock);
     midiin.closePort();
     cout << "Exiting." << endl;
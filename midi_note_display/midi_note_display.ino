@@ -2,6 +2,9 @@
 // Displays REAL-TIME notes from a piano via USB MIDI bridge
 // Notes are shown as 3x3 colored circles with 4-pixel horizontal spacing
 // Colors alternate: blue, cyan, green, magenta, yellow, orange
+// Once five notes fill the staff, each new one slides the others left
+// loop() sleeps until the Serial receive callback wakes it with new bytes
+// (or a scroll step is due) and reports input-to-pixel latency every 5 s
 //
 // Setup:
 //   1. Connect piano MIDI OUT -> USB MIDI dongle -> Mac
@@ -14,9 +17,19 @@
 #include "soc/rtc_cntl_reg.h"
 
 #include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include <esp_timer.h>
 
-// Include the TeachTiles bitmap overlay
-#include "teachtiles_bitmap.h"
+// The TeachTiles staff overlay, pre-inverted and run-length encoded
+// (regenerate with scripts/overlay_pack from teachtiles_overlay.bmp)
+#include "teachtiles_overlay.h"
+
+// Note names, accidentals and staff positions as compile-time tables
+#include "src/note_tables.h"
+// Note sprites drawn over a precomputed background, one note at a time
+#include "src/staff_renderer.h"
+// Receive callback -> loop() byte ring, and the latency histogram
+#include "src/spsc_queue.h"
+#include "src/latency_stats.h"
 
 // Panel size
 #define PANEL_WIDTH 64
@@ -42,6 +55,12 @@ HUB75_I2S_CFG::i2s_pins _pins = {
 
 MatrixPanel_I2S_DMA *display = nullptr;
 
+// Inverted TeachTiles overlay as RGB565, built once in setup(); the renderer
+// restores these pixels when a note moves or is erased and repaints them
+// only when the staff is cleared
+uint16_t staffBackground[StaffRender::PIXELS];
+StaffRender::Renderer<MatrixPanel_I2S_DMA> renderer;
+
 // ============================================
 // STAFF LAYOUT MAPPING (from TeachTiles bitmap)
 // ============================================
@@ -77,6 +96,21 @@ const int STAFF_NOTE_AREA_WIDTH = 22; // Width available for notes (before bar l
 const int NOTE_SPACING = 4;
 const int MAX_NOTES_DISPLAY = 5;  // Max notes that fit in the staff area
 
+// When the staff is full, slide the notes left one pixel every
+// STAFF_SCROLL_STEP_MS to make room for the next one (false: clear the
+// staff and start again on the left, as before)
+const bool STAFF_SCROLL = true;
+const uint32_t STAFF_SCROLL_STEP_MS = 30;
+// Notes on the staff, plus the one scrolling off the left
+const int NOTE_RING_CAPACITY = 8;
+const StaffRender::StaffLayout STAFF_LAYOUT = {
+  TREBLE_STAFF_START_X, NOTE_SPACING, MAX_NOTES_DISPLAY,
+  TREBLE_STAFF_START_X - 1,                      // left column of the first note head
+  TREBLE_STAFF_START_X + STAFF_NOTE_AREA_WIDTH   // notes stop before the bar line
+};
+using NoteStaff = StaffRender::ScrollingStaff<MatrixPanel_I2S_DMA, NOTE_RING_CAPACITY>;
+NoteStaff staff;
+
 // Alternating note colors (RGB values)
 struct Color {
   uint8_t r, g, b;
@@ -93,11 +127,11 @@ const Color NOTE_COLORS[] = {
 const int NUM_COLORS = 6;
 int colorIndex = 0;  // Track which color to use next
 
-// Accidental types
+// Accidental types (same values as NoteTables::Accidental)
 enum Accidental {
-  NATURAL = 0,
-  SHARP = 1,
-  FLAT = 2
+  NATURAL = NoteTables::ACC_NATURAL,
+  SHARP = NoteTables::ACC_SHARP,
+  FLAT = NoteTables::ACC_FLAT
 };
 
 // Octave transposition indicators
@@ -117,8 +151,22 @@ const uint8_t PIANO_MAX_NOTE = 96;   // C7 - highest note on your piano
 const uint8_t DISPLAY_MIN_NOTE = 43; // G2 - bottom line of bass clef (Y=52), F#2 and below shows arrow
 const uint8_t DISPLAY_MAX_NOTE = 77; // F5 - top of treble clef area (Y=11), G5+ shows arrow
 
-// Note names for serial output
-const char* NOTE_NAMES[] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+// USB bridge link. Bytes are stamped in the Serial receive callback and
+// parsed by loop(); one byte is 10 bits on the wire.
+const uint32_t SERIAL_BAUD = 115200;
+const uint32_t SERIAL_BYTE_US = 10 * 1000000 / SERIAL_BAUD;
+struct RxByte {
+  uint8_t byte;
+  bool afterDrop;    // bytes before this one were lost to a full queue
+  uint32_t timeUs;   // micros() when the byte arrived
+};
+SpscQueue<RxByte, 256> rxQueue;
+TaskHandle_t loopTaskHandle = nullptr;
+
+// Input-to-pixel latency: last MIDI byte of a Note On to its sprite written
+// to the panel, reported every LATENCY_REPORT_MS while notes arrive
+const uint32_t LATENCY_REPORT_MS = 5000;
+LatencyStats latency;
 
 // Track active notes with timing (for duration calculation)
 struct ActiveNote {
@@ -129,22 +177,6 @@ struct ActiveNote {
 const int MAX_ACTIVE_NOTES = 16;
 ActiveNote activeNotes[MAX_ACTIVE_NOTES];
 
-// Track displayed notes
-struct DisplayedNote {
-  uint8_t midiNote;       // Original MIDI note
-  uint8_t displayNote;    // Note as displayed (may be transposed)
-  int xPosition;
-  Color color;
-  Accidental accidental;
-  OctaveShift octaveShift; // Whether note was transposed
-  int8_t octavesShifted;   // How many octaves (for 8va vs 15ma display)
-  bool active;
-};
-
-DisplayedNote displayedNotes[MAX_NOTES_DISPLAY];
-int noteCount = 0;
-int nextNoteX = TREBLE_STAFF_START_X;
-
 // ============================================
 // MIDI NOTE TO Y POSITION MAPPING
 // ============================================
@@ -158,185 +190,28 @@ int nextNoteX = TREBLE_STAFF_START_X;
 // natural note but with an accidental symbol drawn beside them.
 
 // Check if a MIDI note is a black key (sharp/flat)
+// C#/F# display as sharps (going up from C/F); Eb/Ab/Bb as flats (going down from E/A/B)
 Accidental getNoteAccidental(uint8_t midiNote) {
-  // Black keys in each octave: C#/Db, D#/Eb, F#/Gb, G#/Ab, A#/Bb
-  // Positions in octave: 1, 3, 6, 8, 10
-  int noteInOctave = midiNote % 12;
-  switch(noteInOctave) {
-    case 1:  // C#/Db - display as sharp (going up from C)
-    case 6:  // F#/Gb - display as sharp (going up from F)
-      return SHARP;
-    case 3:  // D#/Eb - display as flat (going down from E)
-    case 8:  // G#/Ab - display as flat (going down from A)
-    case 10: // A#/Bb - display as flat (going down from B)
-      return FLAT;
-    default:
-      return NATURAL;
-  }
+  return (Accidental)NoteTables::ACCIDENTAL[midiNote];
 }
 
+// Staff layout on the TeachTiles bitmap, measured from the staff lines:
+// TREBLE CLEF LINES: Y = 11, 15, 19, 23, 27 (top to bottom: F5, D5, B4, G4, E4)
+// BASS CLEF LINES: Y = 36, 40, 44, 48, 52 (top to bottom: A3, F3, D3, B2, G2)
+// Middle C (ledger line) = Y 31, each white-key step = 2 pixels (up = smaller Y).
+// Positions are clamped to Y 3..60 so off-staff notes stay on the panel.
+using TeachTilesStaff = NoteTables::Staff<31, 2, 3, 60>;
+
 // Get the Y position for a MIDI note using direct lookup
-// This maps notes to their EXACT positions on the TeachTiles grand staff bitmap
-// Black keys share the line/space of their base note (C# on C, Db on D, etc.)
+// Black keys share the line/space of their base note (C#/Db on C, D#/Eb on D, etc.)
 int getMidiNoteYPosition(uint8_t midiNote) {
-  // DIRECT LOOKUP TABLE for exact Y positions on TeachTiles bitmap
-  // These are measured from the actual bitmap staff lines
-  // Staff lines occur at specific Y values, spaces are between them
-  
-  // From bitmap analysis:
-  // TREBLE CLEF LINES: Y = 11, 15, 19, 23, 27 (top to bottom: F5, D5, B4, G4, E4)
-  // BASS CLEF LINES: Y = 36, 40, 44, 48, 52 (top to bottom: A3, F3, D3, B2, G2)
-  // Space between lines = 2 pixels (for notes in spaces)
-  // Middle C area = Y ~31-32 (between staves)
-  
-  // For notes with sharps/flats, use the natural note's position
-  int noteInOctave = midiNote % 12;
-  int octave = midiNote / 12;  // MIDI octave (C4=60 is octave 5)
-  
-  // Map to white key note number (0=C, 1=D, 2=E, 3=F, 4=G, 5=A, 6=B)
-  int whiteKeyNum;
-  switch(noteInOctave) {
-    case 0: case 1:   whiteKeyNum = 0; break;  // C, C#
-    case 2: case 3:   whiteKeyNum = 1; break;  // D, D#
-    case 4:           whiteKeyNum = 2; break;  // E
-    case 5: case 6:   whiteKeyNum = 3; break;  // F, F#
-    case 7: case 8:   whiteKeyNum = 4; break;  // G, G#
-    case 9: case 10:  whiteKeyNum = 5; break;  // A, A#
-    case 11:          whiteKeyNum = 6; break;  // B
-    default:          whiteKeyNum = 0; break;
-  }
-  
-  // HARDCODED Y positions for each note (based on bitmap analysis)
-  // Reference: Treble E4 (bottom line) = Y27, each step up = -2 pixels
-  // Reference: Bass G2 (bottom line) = Y52, each step up = -2 pixels
-  
-  // Calculate based on octave and note within octave
-  // Using middle C (C4, octave 5) = Y 31 as reference
-  // Each white key step = 2 pixels
-  
-  int y;
-  
-  // Calculate steps from middle C (C4, octave 5, whiteKeyNum 0)
-  int stepsFromMiddleC = (octave - 5) * 7 + whiteKeyNum;
-  
-  // Middle C = Y 31 (just above bass clef, ledger line position)
-  // Going UP (higher pitch) = smaller Y values
-  // Going DOWN (lower pitch) = larger Y values
-  y = 31 - (stepsFromMiddleC * 2);
-  
-  // Clamp to visible area
-  if (y < 3) y = 3;    // Top of display (above treble staff)
-  if (y > 60) y = 60;  // Bottom of display (below bass staff)
-  
-  return y;
-}
-
-// Draw the TeachTiles bitmap overlay (inverted: black staff on white background)
-void drawTeachTilesOverlay() {
-  for (int y = 0; y < PANEL_HEIGHT; y++) {
-    for (int x = 0; x < PANEL_WIDTH; x++) {
-      int idx = y * PANEL_WIDTH + x;
-      uint32_t pixel = pgm_read_dword(&epd_bitmap_TeachTiles_Graphical_Overlay_v1[idx]);
-      
-      // Invert colors (white background becomes black, black lines become white)
-      uint8_t r = 255 - ((pixel >> 16) & 0xFF);
-      uint8_t g = 255 - ((pixel >> 8) & 0xFF);
-      uint8_t b = 255 - (pixel & 0xFF);
-      
-      display->drawPixelRGB888(x, y, r, g, b);
-    }
-  }
-}
-
-// Draw a 3x3 filled square for natural notes
-void drawNoteNatural(int centerX, int centerY, Color color) {
-  // 3x3 filled square
-  // XXX
-  // XXX
-  // XXX
-  for (int dy = -1; dy <= 1; dy++) {
-    for (int dx = -1; dx <= 1; dx++) {
-      display->drawPixelRGB888(centerX + dx, centerY + dy, color.r, color.g, color.b);
-    }
-  }
-}
-
-// Draw a + pattern for sharp notes
-void drawNoteSharp(int centerX, int centerY, Color color) {
-  // 3x3 plus pattern
-  //  X
-  // XXX
-  //  X
-  display->drawPixelRGB888(centerX, centerY - 1, color.r, color.g, color.b);      // Top
-  display->drawPixelRGB888(centerX - 1, centerY, color.r, color.g, color.b);      // Left
-  display->drawPixelRGB888(centerX, centerY, color.r, color.g, color.b);          // Center
-  display->drawPixelRGB888(centerX + 1, centerY, color.r, color.g, color.b);      // Right
-  display->drawPixelRGB888(centerX, centerY + 1, color.r, color.g, color.b);      // Bottom
-}
-
-// Draw an X pattern for flat notes
-void drawNoteFlat(int centerX, int centerY, Color color) {
-  // 3x3 X pattern
-  // X X
-  //  X
-  // X X
-  display->drawPixelRGB888(centerX - 1, centerY - 1, color.r, color.g, color.b);  // Top-left
-  display->drawPixelRGB888(centerX + 1, centerY - 1, color.r, color.g, color.b);  // Top-right
-  display->drawPixelRGB888(centerX, centerY, color.r, color.g, color.b);          // Center
-  display->drawPixelRGB888(centerX - 1, centerY + 1, color.r, color.g, color.b);  // Bottom-left
-  display->drawPixelRGB888(centerX + 1, centerY + 1, color.r, color.g, color.b);  // Bottom-right
+  return TeachTilesStaff::Y[midiNote];
 }
 
-// Draw upward arrow indicator (note is actually higher than shown)
-void drawUpArrow(int centerX, int centerY, Color color) {
-  // Small upward arrow above the note
-  //   X
-  //  XXX
-  int arrowY = centerY - 3;  // Position above the note
-  display->drawPixelRGB888(centerX, arrowY - 1, color.r, color.g, color.b);      // Top point
-  display->drawPixelRGB888(centerX - 1, arrowY, color.r, color.g, color.b);      // Left
-  display->drawPixelRGB888(centerX, arrowY, color.r, color.g, color.b);          // Center
-  display->drawPixelRGB888(centerX + 1, arrowY, color.r, color.g, color.b);      // Right
-}
-
-// Draw downward arrow indicator (note is actually lower than shown)
-void drawDownArrow(int centerX, int centerY, Color color) {
-  // Small downward arrow below the note
-  //  XXX
-  //   X
-  int arrowY = centerY + 3;  // Position below the note
-  display->drawPixelRGB888(centerX - 1, arrowY, color.r, color.g, color.b);      // Left
-  display->drawPixelRGB888(centerX, arrowY, color.r, color.g, color.b);          // Center
-  display->drawPixelRGB888(centerX + 1, arrowY, color.r, color.g, color.b);      // Right
-  display->drawPixelRGB888(centerX, arrowY + 1, color.r, color.g, color.b);      // Bottom point
-}
-
-// Draw a complete note based on accidental type, with optional octave indicator
-void drawNote(int centerX, int centerY, Color color, Accidental accidental, OctaveShift octaveShift = NO_SHIFT) {
-  // Draw the note shape
-  switch (accidental) {
-    case NATURAL:
-      drawNoteNatural(centerX, centerY, color);
-      break;
-    case SHARP:
-      drawNoteSharp(centerX, centerY, color);
-      break;
-    case FLAT:
-      drawNoteFlat(centerX, centerY, color);
-      break;
-  }
-  
-  // Draw octave shift indicator if needed
-  switch (octaveShift) {
-    case SHIFT_UP:
-      drawUpArrow(centerX, centerY, color);
-      break;
-    case SHIFT_DOWN:
-      drawDownArrow(centerX, centerY, color);
-      break;
-    case NO_SHIFT:
-    default:
-      break;
+// Unpack the TeachTiles overlay (white staff on black) to RGB565, once
+void buildStaffBackground() {
+  if (!Overlay::decode(teachtiles_overlay, staffBackground, StaffRender::WIDTH)) {
+    Serial.println("*** ERROR: teachtiles_overlay is corrupt ***");
   }
 }
 
@@ -361,16 +236,23 @@ void getDisplayableNote(uint8_t midiNote, uint8_t &displayNote, OctaveShift &shi
   }
 }
 
-// Add a new note to display
-void addNote(uint8_t midiNote) {
-  if (noteCount >= MAX_NOTES_DISPLAY) {
-    // Clear all notes and start over
-    noteCount = 0;
-    nextNoteX = TREBLE_STAFF_START_X;
-    colorIndex = 0;  // Reset color cycle
-    Serial.println("Staff full - clearing notes");
-  }
-  
+// Sprite for a note: Y from the (possibly transposed) displayed note, shape
+// from its accidental, arrow from its octave shift. X is set by the staff.
+StaffRender::Sprite noteSprite(uint8_t displayNote, Accidental accidental, OctaveShift shift, const Color &color) {
+  StaffRender::Sprite s;
+  s.x = 0;
+  s.y = getMidiNoteYPosition(displayNote);
+  s.colour = StaffRender::rgb565(color.r, color.g, color.b);
+  s.shape = accidental;
+  s.shift = shift;
+  return s;
+}
+
+// Add a new note to the staff and draw it. Once the staff is full the notes
+// scroll left from loop() (or, with STAFF_SCROLL off, the staff is cleared
+// and repainted). inputUs is when the note's last byte arrived; the time to
+// get it on the panel goes into the latency report before anything is printed.
+void addNote(uint8_t midiNote, uint32_t inputUs) {
   // Calculate display note (may be transposed if outside range)
   uint8_t displayNote;
   OctaveShift octaveShift;
@@ -380,17 +262,11 @@ void addNote(uint8_t midiNote) {
   // Detect if this is a sharp/flat (use original note for correct accidental)
   Accidental accidental = getNoteAccidental(midiNote);
   
-  displayedNotes[noteCount].midiNote = midiNote;
-  displayedNotes[noteCount].displayNote = displayNote;
-  displayedNotes[noteCount].xPosition = nextNoteX;
-  displayedNotes[noteCount].color = NOTE_COLORS[colorIndex];
-  displayedNotes[noteCount].accidental = accidental;
-  displayedNotes[noteCount].octaveShift = octaveShift;
-  displayedNotes[noteCount].octavesShifted = octavesShifted;
-  displayedNotes[noteCount].active = true;
-  
-  noteCount++;
-  nextNoteX += NOTE_SPACING;
+  bool cleared = staff.add(noteSprite(displayNote, accidental, octaveShift, NOTE_COLORS[colorIndex]), millis());
+  latency.add(micros() - inputUs);
+  if (cleared) {
+    Serial.println("Staff full - cleared notes");
+  }
   colorIndex = (colorIndex + 1) % NUM_COLORS;  // Cycle to next color
   
   // Enhanced serial output
@@ -412,39 +288,25 @@ void addNote(uint8_t midiNote) {
     Serial.print(")");
   }
   Serial.print(" at X=");
-  Serial.print(displayedNotes[noteCount-1].xPosition);
+  Serial.print(staff.screenX(staff.newest()));
   Serial.print(", Y=");
   Serial.println(getMidiNoteYPosition(displayNote));
 }
 
 // Clear all displayed notes
 void clearNotes() {
-  noteCount = 0;
-  nextNoteX = TREBLE_STAFF_START_X;
+  staff.clear();
+  colorIndex = 0;
 }
 
 // Redraw the entire display (overlay + notes)
 void redrawDisplay() {
-  // First draw the TeachTiles overlay
-  drawTeachTilesOverlay();
-  
-  // Then draw all active notes on top
-  for (int i = 0; i < noteCount; i++) {
-    if (displayedNotes[i].active) {
-      // Use displayNote (which may be transposed) for Y position
-      int y = getMidiNoteYPosition(displayedNotes[i].displayNote);
-      drawNote(displayedNotes[i].xPosition, y, displayedNotes[i].color, 
-               displayedNotes[i].accidental, displayedNotes[i].octaveShift);
-    }
-  }
+  staff.redraw();
 }
 
 // Get note name string (e.g., "C4", "F#5")
 void printNoteName(uint8_t midiNote) {
-  int noteInOctave = midiNote % 12;
-  int octave = (midiNote / 12) - 1;  // MIDI octave convention
-  Serial.print(NOTE_NAMES[noteInOctave]);
-  Serial.print(octave);
+  Serial.print(NoteTables::NAME[midiNote].s);
 }
 
 // Find or create an active note slot
@@ -466,13 +328,32 @@ int findActiveNoteSlot(uint8_t midiNote, bool create) {
   return -1;
 }
 
-// Process incoming MIDI data from Serial (USB bridge)
+// Runs in the UART event task as soon as a byte arrives (RX FIFO threshold
+// 1) or the RX timeout fires. Bytes already waiting arrived earlier, so each
+// is back-dated one byte time per byte that followed it. Wakes loop().
+// When loop() falls so far behind that the queue is full, bytes are dropped
+// (rxQueue.dropped() counts them) and the next queued byte is flagged.
+void onSerialReceive() {
+  static bool dropping = false;
+  uint32_t now = micros();
+  int n = Serial.available();
+  for (int i = 0; i < n; i++) {
+    RxByte rx = {(uint8_t)Serial.read(), dropping, now - (uint32_t)(n - 1 - i) * SERIAL_BYTE_US};
+    dropping = !rxQueue.push(rx);
+  }
+  if (loopTaskHandle) xTaskNotifyGive(loopTaskHandle);
+}
+
+// Parse the MIDI bytes the receive callback queued (USB bridge)
 void processMIDI() {
   static uint8_t midiBuffer[3];
   static int midiBufferIndex = 0;
   
-  while (Serial.available()) {
-    uint8_t byte = Serial.read();
+  RxByte rx;
+  while (rxQueue.pop(rx)) {
+    uint8_t byte = rx.byte;
+    // A message cut by dropped bytes must not be completed with later data
+    if (rx.afterDrop) midiBufferIndex = 0;
     
     // Check for status byte (Note On = 0x90, Note Off = 0x80)
     if (byte & 0x80) {
@@ -496,15 +377,16 @@ void processMIDI() {
             activeNotes[slot].active = true;
           }
           
+          // Draw just the new note first (the staff scrolls from loop()),
+          // then log it
+          addNote(note, rx.timeUs);
+          
           Serial.print("♪ NOTE ON:  ");
           printNoteName(note);
           Serial.print(" (MIDI ");
           Serial.print(note);
           Serial.print(") vel=");
           Serial.println(velocity);
-          
-          addNote(note);
-          redrawDisplay();
         }
         else if (status == 0x80 || (status == 0x90 && velocity == 0)) {
           // Note Off
@@ -534,7 +416,9 @@ void setup() {
   // Disable brownout detector - LED matrix causes voltage drops during init
   WRITE_PERI_REG(RTC_CNTL_BROWN_OUT_REG, 0);
   
-  Serial.begin(115200);
+  // Buffer console output so printing a note never stalls the next one
+  Serial.setTxBufferSize(1024);
+  Serial.begin(SERIAL_BAUD);
   delay(1000);
   Serial.println("\n\n========================================");
   Serial.println("=== MIDI Note Display on TeachTiles ===");
@@ -563,10 +447,19 @@ void setup() {
   display->clearScreen();
   
   // Draw initial overlay
-  drawTeachTilesOverlay();
+  buildStaffBackground();
+  renderer.begin(display, staffBackground);
+  staff.begin(&renderer, STAFF_LAYOUT, STAFF_SCROLL_STEP_MS, STAFF_SCROLL);
+  redrawDisplay();
   
   Serial.println("TeachTiles overlay displayed!");
   Serial.println("");
+  // Wake loop() the moment bytes arrive instead of polling
+  loopTaskHandle = xTaskGetCurrentTaskHandle();
+  Serial.setRxFIFOFull(1);
+  Serial.setRxTimeout(1);
+  Serial.onReceive(onSerialReceive);
+  
   Serial.println("Waiting for MIDI from USB bridge...");
   Serial.println("Run: python3 scripts/midi_to_esp32.py");
   Serial.println("");
@@ -586,9 +479,31 @@ void setup() {
   Serial.println(" (notes outside transposed by octave)");
 }
 
+// Print the input-to-pixel latency of the notes since the last report, and
+// how many received bytes the full queue dropped meanwhile
+void reportLatency() {
+  static uint32_t droppedReported = 0;
+  LatencyStats::Report r;
+  if (!latency.take((uint64_t)esp_timer_get_time(), LATENCY_REPORT_MS * 1000ull, r)) return;
+  uint32_t dropped = rxQueue.dropped();
+  Serial.printf("(latency) input->pixel: %u notes | p50 %u us | p99 %u us | max %u us | %u rx bytes dropped\n",
+                (unsigned)r.count, (unsigned)r.p50Us, (unsigned)r.p99Us, (unsigned)r.maxUs,
+                (unsigned)(dropped - droppedReported));
+  droppedReported = dropped;
+}
+
 void loop() {
-  // Process real-time MIDI input from piano
+  // Parse and draw whatever arrived, slide the notes along while a scroll
+  // is in progress
   processMIDI();
+  staff.tick(millis());
+  reportLatency();
   
-  delay(10);  // Small delay, fast response for real-time input
+  // Sleep until the receive callback signals new bytes or the next scroll
+  // step is due; with nothing to animate, wait indefinitely (just long
+  // enough to print a pending latency report). The idle task runs meanwhile.
+  uint32_t waitMs = staff.msUntilNextStep(millis());
+  if (latency.count() > 0 && waitMs > LATENCY_REPORT_MS) waitMs = LATENCY_REPORT_MS;
+  if (waitMs == 0) return;
+  ulTaskNotifyTake(pdTRUE, waitMs == NoteStaff::NO_STEP ? portMAX_DELAY : pdMS_TO_TICKS(waitMs));
 }
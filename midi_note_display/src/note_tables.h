@@ -0,0 +1,146 @@
+#pragma once
+
+// note_tables.h - per-note metadata as constexpr 128-entry tables, shared by
+// the firmware (main.cpp), the Monalith visualizer and the staff display
+// sketch (midi_note_display). Tables are built at compile time, so every
+// lookup on a hot path is a single indexed load. Entries that depend on the
+// panel or staff layout are templates parameterized on that geometry.
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace NoteTables {
+
+constexpr size_t NOTE_COUNT = 128;
+
+// Black keys are spelled the way the staff display draws them: C# and F# as
+// sharps (up from C/F), Eb, Ab and Bb as flats (down from E/A/B).
+enum Accidental : uint8_t { ACC_NATURAL = 0, ACC_SHARP = 1, ACC_FLAT = 2 };
+
+template <typename T>
+struct Table {
+    T v[NOTE_COUNT];
+    constexpr const T& operator[](uint8_t note) const { return v[note & 0x7F]; }
+};
+
+// "C-1" .. "G9", NUL-terminated
+struct NoteName { char s[5]; };
+
+// Position in the octave -> white key (0=C .. 6=B) the note is drawn on
+constexpr uint8_t WHITE_KEY_IN_OCTAVE[12] = {0, 0, 1, 1, 2, 3, 3, 4, 4, 5, 5, 6};
+constexpr uint8_t ACCIDENTAL_IN_OCTAVE[12] = {
+    ACC_NATURAL, ACC_SHARP, ACC_NATURAL, ACC_FLAT, ACC_NATURAL, ACC_NATURAL,
+    ACC_SHARP, ACC_NATURAL, ACC_FLAT, ACC_NATURAL, ACC_FLAT, ACC_NATURAL,
+};
+
+constexpr Table<NoteName> makeNames() {
+    const char* pc[12] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+    Table<NoteName> t{};
+    for (int n = 0; n < (int)NOTE_COUNT; ++n) {
+        char* s = t.v[n].s;
+        int i = 0;
+        for (const char* p = pc[n % 12]; *p; ++p) s[i++] = *p;
+        int octave = n / 12 - 1;
+        if (octave < 0) { s[i++] = '-'; octave = -octave; }
+        s[i++] = (char)('0' + octave);
+        s[i] = '\0';
+    }
+    return t;
+}
+
+constexpr Table<uint8_t> makePitchClasses() {
+    Table<uint8_t> t{};
+    for (int n = 0; n < (int)NOTE_COUNT; ++n) t.v[n] = (uint8_t)(n % 12);
+    return t;
+}
+
+constexpr Table<int8_t> makeOctaves() {
+    Table<int8_t> t{};
+    for (int n = 0; n < (int)NOTE_COUNT; ++n) t.v[n] = (int8_t)(n / 12 - 1);
+    return t;
+}
+
+constexpr Table<uint8_t> makeAccidentals() {
+    Table<uint8_t> t{};
+    for (int n = 0; n < (int)NOTE_COUNT; ++n) t.v[n] = ACCIDENTAL_IN_OCTAVE[n % 12];
+    return t;
+}
+
+// White keys counted from C-1 (MIDI 0); middle C (60) is white key 35
+constexpr Table<uint8_t> makeWhiteKeys() {
+    Table<uint8_t> t{};
+    for (int n = 0; n < (int)NOTE_COUNT; ++n) t.v[n] = (uint8_t)((n / 12) * 7 + WHITE_KEY_IN_OCTAVE[n % 12]);
+    return t;
+}
+
+// Hue 0-255, one twelfth of the colour wheel per pitch class
+constexpr Table<uint8_t> makeHues() {
+    Table<uint8_t> t{};
+    for (int n = 0; n < (int)NOTE_COUNT; ++n) t.v[n] = (uint8_t)((n % 12) * (256 / 12));
+    return t;
+}
+
+inline constexpr Table<NoteName> NAME = makeNames();
+inline constexpr Table<uint8_t> PITCH_CLASS = makePitchClasses();
+inline constexpr Table<int8_t> OCTAVE = makeOctaves();
+inline constexpr Table<uint8_t> ACCIDENTAL = makeAccidentals();
+inline constexpr Table<uint8_t> WHITE_KEY = makeWhiteKeys();
+inline constexpr Table<uint8_t> HUE = makeHues();
+
+constexpr uint8_t MIDDLE_C = 60;
+constexpr uint8_t MIDDLE_C_WHITE_KEY = 35;
+
+// LED matrix layout: serpentine rows, notes of the 88-key piano range
+// (A0..C8) spread across the width on the middle row.
+template <int Width, int Height>
+struct Panel {
+    static constexpr int PIANO_MIN_NOTE = 21;
+    static constexpr int PIANO_MAX_NOTE = 108;
+
+    static constexpr int xyToIndex(int x, int y) {
+        if (x < 0) x = 0;
+        if (x >= Width) x = Width - 1;
+        if (y < 0) y = 0;
+        if (y >= Height) y = Height - 1;
+        // even rows run left-to-right, odd rows right-to-left
+        return (y % 2 == 0) ? y * Width + x : y * Width + (Width - 1 - x);
+    }
+
+    static constexpr Table<uint16_t> makeLedIndex() {
+        Table<uint16_t> t{};
+        const int range = PIANO_MAX_NOTE - PIANO_MIN_NOTE + 1;
+        for (int n = 0; n < (int)NOTE_COUNT; ++n) {
+            int clamped = n < PIANO_MIN_NOTE ? PIANO_MIN_NOTE : (n > PIANO_MAX_NOTE ? PIANO_MAX_NOTE : n);
+            int x = ((clamped - PIANO_MIN_NOTE) * Width) / range;
+            t.v[n] = (uint16_t)xyToIndex(x, Height / 2);
+        }
+        return t;
+    }
+
+    static constexpr Table<uint16_t> LED_INDEX = makeLedIndex();
+};
+
+// Grand-staff layout: Y of middle C, pixels per white-key step, and the
+// visible Y range notes are clamped to. Black keys share their base line/space.
+template <int MiddleCY, int StepPx, int MinY, int MaxY>
+struct Staff {
+    static constexpr Table<int8_t> makeY() {
+        Table<int8_t> t{};
+        for (int n = 0; n < (int)NOTE_COUNT; ++n) {
+            int y = MiddleCY - (WHITE_KEY.v[n] - MIDDLE_C_WHITE_KEY) * StepPx;
+            if (y < MinY) y = MinY;
+            if (y > MaxY) y = MaxY;
+            t.v[n] = (int8_t)y;
+        }
+        return t;
+    }
+
+    static constexpr Table<int8_t> Y = makeY();
+};
+
+static_assert(NAME.v[60].s[0] == 'C' && NAME.v[60].s[1] == '4', "middle C is C4");
+static_assert(NAME.v[0].s[1] == '-' && NAME.v[127].s[0] == 'G', "name range");
+static_assert(WHITE_KEY.v[MIDDLE_C] == MIDDLE_C_WHITE_KEY, "middle C white key");
+static_assert(ACCIDENTAL.v[61] == ACC_SHARP && ACCIDENTAL.v[70] == ACC_FLAT, "accidental spelling");
+
+} // namespace NoteTables
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "src/overlay_asset.h"
+
+// 64x64 overlay, rle, 361 bytes (generated by scripts/overlay_pack)
+static const uint16_t teachtiles_overlay_palette[2] = {0x0000, 0xFFFF};
+static const uint8_t teachtiles_overlay_data[357] = {
+    0xF0, 0xF8, 0x21, 0xF0, 0x2C, 0x11, 0x00, 0x11, 0xF0, 0x2A, 0x11, 0x20, 0x01, 0xF0, 0x2A, 0x11,
+    0x20, 0x01, 0xF0, 0x2A, 0x11, 0x20, 0x01, 0xF0, 0x2A, 0x11, 0x10, 0x01, 0xF0, 0x2B, 0x11, 0x00,
+    0x11, 0xF0, 0x2B, 0x31, 0x60, 0xF1, 0x09, 0xF0, 0x0C, 0x31, 0x50, 0x01, 0xF0, 0x09, 0x01, 0xF0,
+    0x0A, 0x31, 0x60, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x09, 0x31, 0x70, 0x01, 0xF0, 0x09, 0x01, 0xF0,
+    0x08, 0x21, 0x00, 0x01, 0x70, 0xF1, 0x0B, 0xF0, 0x07, 0x21, 0x10, 0x21, 0x50, 0x01, 0xF0, 0x09,
+    0x01, 0xF0, 0x06, 0x21, 0x10, 0x41, 0x40, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x06, 0x21, 0x00, 0x61,
+    0x30, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x06, 0x21, 0x00, 0x21, 0x10, 0x21, 0x20, 0xF1, 0x0B, 0xF0,
+    0x06, 0x21, 0x00, 0x21, 0x20, 0x11, 0x20, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x06, 0x21, 0x10, 0x21,
+    0x10, 0x11, 0x20, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x07, 0x21, 0x10, 0x01, 0x20, 0x11, 0x20, 0x01,
+    0xF0, 0x09, 0x01, 0xF0, 0x08, 0x21, 0x00, 0x01, 0x10, 0x11, 0x30, 0xF1, 0x0B, 0xF0, 0x09, 0x61,
+    0x40, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x0C, 0x01, 0x70, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x0A, 0x01,
+    0x00, 0x01, 0x70, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x09, 0x31, 0x80, 0xF1, 0x09, 0xF0, 0x0A, 0x31,
+    0xF0, 0x2D, 0x11, 0xF0, 0x7A, 0xF1, 0x09, 0xF0, 0xCA, 0x31, 0x80, 0xF1, 0x09, 0xF0, 0x08, 0x61,
+    0x60, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x06, 0x21, 0x30, 0x11, 0x20, 0x01, 0x10, 0x01, 0xF0, 0x09,
+    0x01, 0xF0, 0x06, 0x01, 0x50, 0x21, 0x00, 0x21, 0x00, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x06, 0x01,
+    0x00, 0x11, 0x30, 0x11, 0x10, 0x01, 0x10, 0xF1, 0x0B, 0xF0, 0x06, 0x41, 0x20, 0x11, 0x40, 0x01,
+    0xF0, 0x09, 0x01, 0xF0, 0x06, 0x41, 0x20, 0x11, 0x10, 0x01, 0x10, 0x01, 0xF0, 0x09, 0x01, 0xF0,
+    0x07, 0x31, 0x10, 0x21, 0x00, 0x21, 0x00, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x08, 0x11, 0x20, 0x11,
+    0x20, 0x01, 0x10, 0xF1, 0x0B, 0xF0, 0x0C, 0x21, 0x50, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x0B, 0x21,
+    0x60, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x0A, 0x21, 0x70, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x09, 0x21,
+    0x80, 0xF1, 0x0B, 0xF0, 0x08, 0x21, 0x90, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x07, 0x21, 0xA0, 0x01,
+    0xF0, 0x09, 0x01, 0xF0, 0x07, 0x11, 0xB0, 0x01, 0xF0, 0x09, 0x01, 0xF0, 0x16, 0xF1, 0x09, 0xF0,
+    0xFF, 0xF0, 0xFF, 0xF0, 0xE8,
+};
+extern const OverlayAsset teachtiles_overlay;
+const OverlayAsset teachtiles_overlay = {4, 2, 64, 64, teachtiles_overlay_palette, teachtiles_overlay_data, 357};
@@ -0,0 +1,273 @@
+#pragma once
+
+// backend.h - display drivers for the Monalith visualizer. Monalith renders
+// every frame into its RGB565 canvas (framebuffer.h) and hands the changed
+// spans to exactly one backend, picked at compile time with MONALITH_BACKEND.
+// All backends share one interface and are called directly (no virtuals):
+//
+//   bool begin();                                 bring up the driver, clear the panel
+//   void setBrightness(uint8_t b);                0..255
+//   void drawSpan(int x, int y, const uint16_t* px, int n);   n RGB565 pixels of row y from x
+//   void blit(const uint16_t* frame);             whole WIDTH x HEIGHT RGB565 frame
+//   void present();                               make what was drawn visible
+//   void refresh();                               called every tick(), changed or not;
+//                                                 drivers that scan the panel from the CPU do it here
+//
+// NAME names the driver in logs.
+
+#include <stdint.h>
+#include <string.h>
+#include <cstdio>
+#include "backend_select.h"
+
+// HUB75 wiring shared by the PxMatrix and I2S-DMA backends; override with -DP_xxx_PIN=n
+#ifndef P_R1_PIN
+#define P_R1_PIN 25
+#endif
+#ifndef P_G1_PIN
+#define P_G1_PIN 26
+#endif
+#ifndef P_B1_PIN
+#define P_B1_PIN 27
+#endif
+#ifndef P_R2_PIN
+#define P_R2_PIN 14
+#endif
+#ifndef P_G2_PIN
+#define P_G2_PIN 12
+#endif
+#ifndef P_B2_PIN
+#define P_B2_PIN 13
+#endif
+#ifndef P_E_PIN
+#define P_E_PIN 32
+#endif
+#ifndef P_A_PIN
+#define P_A_PIN 23
+#endif
+#ifndef P_B_PIN
+#define P_B_PIN 19
+#endif
+#ifndef P_C_PIN
+#define P_C_PIN 5
+#endif
+#ifndef P_D_PIN
+#define P_D_PIN 17
+#endif
+#ifndef P_CLK_PIN
+#define P_CLK_PIN 16
+#endif
+#ifndef P_LAT_PIN
+#define P_LAT_PIN 4
+#endif
+#ifndef P_OE_PIN
+#define P_OE_PIN 15
+#endif
+
+// I2S-DMA tuning. Fewer colour bit planes and less latch blanking raise the
+// refresh rate the driver can reach; min refresh makes it lower the depth
+// (or fail begin()) rather than flicker.
+#ifndef MONALITH_DMA_COLOR_DEPTH
+#define MONALITH_DMA_COLOR_DEPTH 0          // bit planes per channel; 0 = library default
+#endif
+#ifndef MONALITH_DMA_LATCH_BLANKING
+#define MONALITH_DMA_LATCH_BLANKING 2       // OE blanking clocks around each latch (ghosting vs brightness)
+#endif
+#ifndef MONALITH_DMA_MIN_REFRESH_HZ
+#define MONALITH_DMA_MIN_REFRESH_HZ 120     // lowest acceptable full-panel refresh rate
+#endif
+
+#if MONALITH_BACKEND == MONALITH_BACKEND_PXMATRIX
+#if defined(ESP32)
+#include <driver/gpio.h>
+#include <soc/gpio_struct.h>
+#endif
+#include <PxMatrix.h>
+#elif MONALITH_BACKEND == MONALITH_BACKEND_I2S_DMA
+#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#elif MONALITH_BACKEND == MONALITH_BACKEND_FASTLED
+#include <FastLED.h>
+#endif
+
+namespace Monalith {
+
+#if MONALITH_BACKEND == MONALITH_BACKEND_HOST
+// Pure-software panel: keeps the pushed pixels so host tests and benchmarks
+// can inspect exactly what a real driver would have received.
+template <int W, int H>
+class HostBackend {
+public:
+    static constexpr const char* NAME = "host framebuffer";
+
+    bool begin() {
+        memset(frame_, 0, sizeof(frame_));
+        return true;
+    }
+    void setBrightness(uint8_t b) { brightness_ = b; }
+    void drawSpan(int x, int y, const uint16_t* px, int n) { memcpy(&frame_[y * W + x], px, n * sizeof(uint16_t)); }
+    void blit(const uint16_t* frame) { memcpy(frame_, frame, sizeof(frame_)); }
+    void present() { ++presents_; }
+    void refresh() {}
+
+    const uint16_t* frame() const { return frame_; }
+    uint8_t brightness() const { return brightness_; }
+    uint32_t presents() const { return presents_; }
+
+private:
+    uint16_t frame_[W * H] = {};
+    uint8_t brightness_ = 255;
+    uint32_t presents_ = 0;
+};
+#endif
+
+#if MONALITH_BACKEND == MONALITH_BACKEND_PXMATRIX
+// PxMatrix keeps its own frame and has no bulk write, so spans are plotted pixel by pixel.
+template <int W, int H>
+class PxMatrixBackend {
+public:
+    static constexpr const char* NAME = "PxMatrix (HUB75)";
+
+    bool begin() {
+        // Force-panel control pins to outputs early to avoid external dongles
+        // holding strapping lines and disabling the panel
+        pinMode(P_OE_PIN, OUTPUT);
+        pinMode(P_LAT_PIN, OUTPUT);
+        pinMode(P_CLK_PIN, OUTPUT);
+        // Drive OE low (enable output), toggle LAT and CLK to a known state
+        digitalWrite(P_OE_PIN, LOW); // enable panel
+        digitalWrite(P_LAT_PIN, HIGH);
+        digitalWrite(P_LAT_PIN, LOW);
+        digitalWrite(P_CLK_PIN, LOW);
+        std::printf("Monalith: forced OE=%d LAT=%d CLK=%d\n", digitalRead(P_OE_PIN), digitalRead(P_LAT_PIN), digitalRead(P_CLK_PIN));
+
+        // Provide explicit row scan. Most 64x64 HUB75 panels are 1/32 scan —
+        // use 32 here. If your panel is different, change the first argument
+        // accordingly (e.g., 8 or 16). PxMatrix begin() signatures vary by
+        // library version; use the single-arg form here for portability.
+        matrix_.begin(32);
+        matrix_.setBrightness(50);
+        matrix_.clearDisplay();
+        matrix_.display();
+        // Print configured pin mapping for verification
+        std::printf("Monalith: PxMatrix pins LAT=%d OE=%d A=%d B=%d C=%d D=%d CLK=%d R1=%d G1=%d B1=%d R2=%d G2=%d B2=%d E=%d\n",
+                    P_LAT_PIN, P_OE_PIN, P_A_PIN, P_B_PIN, P_C_PIN, P_D_PIN, P_CLK_PIN,
+                    P_R1_PIN, P_G1_PIN, P_B1_PIN, P_R2_PIN, P_G2_PIN, P_B2_PIN, P_E_PIN);
+        return true;
+    }
+    void setBrightness(uint8_t b) { matrix_.setBrightness(b); }
+    void drawSpan(int x, int y, const uint16_t* px, int n) {
+        for (int i = 0; i < n; ++i) matrix_.drawPixel(x + i, y, px[i]);
+    }
+    void blit(const uint16_t* frame) {
+        for (int y = 0; y < H; ++y) drawSpan(0, y, frame + y * W, W);
+    }
+    // The panel only lights while display() scans its rows, so it runs on
+    // every tick() through refresh(), also when the frame did not change;
+    // present() has nothing left to do
+    void present() {}
+    void refresh() { matrix_.display(); }
+
+private:
+    // Include P_E_PIN when constructing PxMATRIX in case the panel requires 5 address lines
+    PxMATRIX matrix_{W, H, P_LAT_PIN, P_OE_PIN, P_A_PIN, P_B_PIN, P_C_PIN, P_D_PIN, P_E_PIN};
+};
+#endif
+
+#if MONALITH_BACKEND == MONALITH_BACKEND_I2S_DMA
+// ESP32-HUB75-MatrixPanel-I2S-DMA: the I2S peripheral streams the bit planes
+// to the panel by DMA, so refresh costs no CPU, and pixels written to the DMA
+// buffer show on the next refresh without any present step. Configured like
+// the midi_note_display/dma_test sketches (FM6126A driver, E line on GPIO32).
+template <int W, int H>
+class I2sDmaBackend {
+public:
+    static constexpr const char* NAME = "I2S-DMA (HUB75)";
+
+    bool begin() {
+        HUB75_I2S_CFG::i2s_pins pins = {P_R1_PIN, P_G1_PIN, P_B1_PIN, P_R2_PIN, P_G2_PIN, P_B2_PIN,
+                                        P_A_PIN, P_B_PIN, P_C_PIN, P_D_PIN, P_E_PIN, P_LAT_PIN, P_OE_PIN, P_CLK_PIN};
+        HUB75_I2S_CFG cfg(W, H, 1, pins);
+        cfg.gpio.e = P_E_PIN;
+        cfg.clkphase = false;
+        cfg.driver = HUB75_I2S_CFG::FM6126A;
+        cfg.latch_blanking = MONALITH_DMA_LATCH_BLANKING;
+        cfg.min_refresh_rate = MONALITH_DMA_MIN_REFRESH_HZ;
+        display_ = new MatrixPanel_I2S_DMA(cfg);
+#if MONALITH_DMA_COLOR_DEPTH
+        display_->setPixelColorDepthBits(MONALITH_DMA_COLOR_DEPTH);
+#endif
+        if (!display_->begin()) return false;
+        display_->setBrightness8(128);
+        display_->clearScreen();
+        std::printf("Monalith: I2S-DMA colour depth=%d latch blanking=%d min refresh=%d Hz\n",
+                    MONALITH_DMA_COLOR_DEPTH, MONALITH_DMA_LATCH_BLANKING, MONALITH_DMA_MIN_REFRESH_HZ);
+        return true;
+    }
+    void setBrightness(uint8_t b) { display_->setBrightness8(b); }
+    void drawSpan(int x, int y, const uint16_t* px, int n) {
+        for (int i = 0; i < n; ++i) display_->drawPixel(x + i, y, px[i]);
+    }
+    void blit(const uint16_t* frame) {
+        for (int y = 0; y < H; ++y) drawSpan(0, y, frame + y * W, W);
+    }
+    void present() {}
+    void refresh() {}
+
+private:
+    MatrixPanel_I2S_DMA* display_ = nullptr;
+};
+#endif
+
+#if MONALITH_BACKEND == MONALITH_BACKEND_FASTLED
+// WS2812 matrix wired as serpentine rows. A strip has no partial update, so
+// spans only refresh leds[] and present() clocks out the whole chain.
+#ifndef MONALITH_LED_PIN
+#define MONALITH_LED_PIN 5
+#endif
+template <int W, int H>
+class FastLedBackend {
+public:
+    static constexpr const char* NAME = "FastLED";
+
+    bool begin() {
+        FastLED.addLeds<NEOPIXEL, MONALITH_LED_PIN>(leds_, W * H);
+        FastLED.clear();
+        FastLED.show();
+        return true;
+    }
+    void setBrightness(uint8_t b) { FastLED.setBrightness(b); }
+    void drawSpan(int x, int y, const uint16_t* px, int n) {
+        // even rows run left-to-right, odd rows right-to-left
+        for (int i = 0; i < n; ++i) {
+            int cx = x + i;
+            leds_[(y % 2 == 0) ? y * W + cx : y * W + (W - 1 - cx)] = expand(px[i]);
+        }
+    }
+    void blit(const uint16_t* frame) {
+        for (int y = 0; y < H; ++y) drawSpan(0, y, frame + y * W, W);
+    }
+    void present() { FastLED.show(); }
+    void refresh() {}
+
+private:
+    static CRGB expand(uint16_t c) {
+        uint8_t r5 = (c >> 11) & 0x1F, g6 = (c >> 5) & 0x3F, b5 = c & 0x1F;
+        return CRGB((uint8_t)((r5 << 3) | (r5 >> 2)), (uint8_t)((g6 << 2) | (g6 >> 4)), (uint8_t)((b5 << 3) | (b5 >> 2)));
+    }
+    CRGB leds_[W * H];
+};
+#endif
+
+template <int W, int H>
+using Backend =
+#if MONALITH_BACKEND == MONALITH_BACKEND_PXMATRIX
+    PxMatrixBackend<W, H>;
+#elif MONALITH_BACKEND == MONALITH_BACKEND_I2S_DMA
+    I2sDmaBackend<W, H>;
+#elif MONALITH_BACKEND == MONALITH_BACKEND_FASTLED
+    FastLedBackend<W, H>;
+#else
+    HostBackend<W, H>;
+#endif
+
+} // namespace Monalith
@@ -0,0 +1,22 @@
+#pragma once
+
+// backend_select.h - which display driver Monalith is built for. Only the
+// MONALITH_BACKEND choice, without the drivers themselves, so headers whose
+// tables depend on it (palette.h) can include it without a panel library.
+
+#define MONALITH_BACKEND_HOST 0      // software framebuffer (tests, benchmarks, Linux)
+#define MONALITH_BACKEND_PXMATRIX 1  // HUB75 via the PxMatrix library
+#define MONALITH_BACKEND_I2S_DMA 2   // HUB75 via ESP32-HUB75-MatrixPanel-I2S-DMA
+#define MONALITH_BACKEND_FASTLED 3   // serpentine WS2812 matrix via FastLED
+
+#if !defined(MONALITH_BACKEND) && defined(USE_PXMATRIX)
+#define MONALITH_BACKEND MONALITH_BACKEND_PXMATRIX
+#endif
+#ifndef MONALITH_BACKEND
+#if defined(ARDUINO) && defined(ESP32)
+// I2S DMA refreshes the panel in hardware; PxMatrix needs the CPU for every row scan
+#define MONALITH_BACKEND MONALITH_BACKEND_I2S_DMA
+#else
+#define MONALITH_BACKEND MONALITH_BACKEND_HOST
+#endif
+#endif
@@ -0,0 +1,132 @@
+#pragma once
+
+// compositor.h - Monalith's layer stack, bottom to top: a cached background
+// (the static bitmap / staff overlay, black when none is set), the note layer
+// and the annotation layer for glyphs. Note and annotation pixels are RGB565
+// with 0 meaning transparent. Every layer write marks its row dirty, and
+// compose() rebuilds only the dirty rows of the canvas from the stack, so
+// notes animating over the staff no longer re-blit the whole background.
+
+#include <stdint.h>
+#include <string.h>
+#include "framebuffer.h"
+
+namespace Monalith {
+
+enum class Layer : uint8_t { Background, Notes, Annotations };
+
+template <int Width, int Height>
+class Compositor {
+public:
+    using Rows = RowMask<Height>;
+
+    static constexpr uint16_t TRANSPARENT = 0;
+    static constexpr size_t PIXELS = (size_t)Width * Height;
+
+    // Replace the cached background; nullptr makes it black
+    void setBackground(const uint16_t* src) {
+        if (src) memcpy(background_, src, sizeof(background_));
+        else memset(background_, 0, sizeof(background_));
+        dirty_.setAll();
+    }
+    const uint16_t* background() const { return background_; }
+
+    // Write access to the background (Width pixels per row) for decoders
+    // that unpack an overlay in place; every row is recomposed
+    uint16_t* editBackground() {
+        dirty_.setAll();
+        return background_;
+    }
+
+    // Write one pixel of the note or annotation layer (out of range is ignored)
+    void set(Layer layer, int x, int y, uint16_t c) {
+        if (x < 0 || x >= Width || y < 0 || y >= Height) return;
+        Plane& p = plane(layer);
+        uint16_t& px = p.px[y * Width + x];
+        if (px == c) return;
+        px = c;
+        p.used.set(y);
+        dirty_.set(y);
+    }
+
+    // Write n pixels of row y from x in one go, clipped to the panel
+    void fillSpan(Layer layer, int x, int y, int n, uint16_t c) {
+        if (y < 0 || y >= Height) return;
+        if (x < 0) { n += x; x = 0; }
+        if (x + n > Width) n = Width - x;
+        if (n <= 0) return;
+        Plane& p = plane(layer);
+        uint16_t* px = p.px + y * Width + x;
+        bool changed = false;
+        for (int i = 0; i < n; ++i) {
+            if (px[i] == c) continue;
+            px[i] = c;
+            changed = true;
+        }
+        if (!changed) return;
+        p.used.set(y);
+        dirty_.set(y);
+    }
+
+    // Make the note or annotation layer fully transparent. Only rows that
+    // held pixels are wiped and recomposed.
+    void clear(Layer layer) {
+        Plane& p = plane(layer);
+        for (int y = 0; y < Height; ++y) {
+            if (!p.used.test(y)) continue;
+            memset(p.px + y * Width, 0, Width * sizeof(uint16_t));
+            dirty_.set(y);
+        }
+        p.used.clear();
+    }
+
+    // Something else painted the canvas (self-test, demo); rebuild every row
+    void invalidate() { dirty_.setAll(); }
+
+    bool dirty() const { return dirty_.any(); }
+    const Rows& dirtyRows() const { return dirty_; }
+
+    // Rebuild the dirty rows of the canvas' draw buffer: the top opaque pixel
+    // of each column wins. Rows without note or annotation pixels are a
+    // straight copy of the background. Returns the number of rows composed.
+    template <typename Canvas>
+    int compose(Canvas& canvas) {
+        int rows = 0;
+        for (int y = 0; y < Height; ++y) {
+            if (!dirty_.test(y)) continue;
+            uint16_t* out = canvas.drawRow(y);
+            const uint16_t* bg = background_ + y * Width;
+            bool hasNotes = notes_.used.test(y);
+            bool hasAnnotations = annotations_.used.test(y);
+            if (!hasNotes && !hasAnnotations) {
+                memcpy(out, bg, Width * sizeof(uint16_t));
+            } else {
+                const uint16_t* n = notes_.px + y * Width;
+                const uint16_t* a = annotations_.px + y * Width;
+                for (int x = 0; x < Width; ++x) {
+                    uint16_t c = bg[x];
+                    if (hasNotes && n[x] != TRANSPARENT) c = n[x];
+                    if (hasAnnotations && a[x] != TRANSPARENT) c = a[x];
+                    out[x] = c;
+                }
+            }
+            ++rows;
+        }
+        dirty_.clear();
+        return rows;
+    }
+
+private:
+    struct Plane {
+        uint16_t px[PIXELS] = {};
+        Rows used;   // rows with at least one pixel written since the last clear()
+    };
+    Plane& plane(Layer layer) { return layer == Layer::Annotations ? annotations_ : notes_; }
+
+    uint16_t background_[PIXELS] = {};
+    Plane notes_;
+    Plane annotations_;
+    Rows dirty_;
+};
+
+} // namespace Monalith
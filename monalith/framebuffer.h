@@ -0,0 +1,113 @@
+#pragma once
+
+// framebuffer.h - double-buffered RGB565 canvas owned by Monalith.
+// Every drawing call writes the draw buffer; present() swaps it with the
+// shown buffer and hands the new frame (plus the previous one, for diffing)
+// to the panel backend in a single call. The draw buffer is then re-seeded
+// with the shown frame so incremental drawing carries over between frames.
+// Writes mark their row as touched; present() compares only touched rows
+// against the shown frame, hands the backend the rows that really changed,
+// and skips the frame entirely when none did.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace Monalith {
+
+// One bit per panel row
+template <int Height>
+struct RowMask {
+    static constexpr int WORDS = (Height + 31) / 32;
+    uint32_t w[WORDS] = {};
+
+    void set(int y) { w[y >> 5] |= 1u << (y & 31); }
+    bool test(int y) const { return (w[y >> 5] >> (y & 31)) & 1u; }
+    void setAll() { for (int y = 0; y < Height; ++y) set(y); }
+    void clear() { for (int i = 0; i < WORDS; ++i) w[i] = 0; }
+    bool any() const {
+        for (int i = 0; i < WORDS; ++i) if (w[i]) return true;
+        return false;
+    }
+    int count() const {
+        int n = 0;
+        for (int y = 0; y < Height; ++y) n += test(y);
+        return n;
+    }
+};
+
+template <int Width, int Height>
+class FrameBuffer565 {
+public:
+    using Rows = RowMask<Height>;
+
+    static constexpr int WIDTH = Width;
+    static constexpr int HEIGHT = Height;
+    static constexpr size_t PIXELS = (size_t)Width * Height;
+    static constexpr size_t BYTES = PIXELS * sizeof(uint16_t);
+
+    uint16_t* draw() { return draw_; }
+    const uint16_t* shown() const { return shown_; }
+
+    void set(int x, int y, uint16_t c) {
+        if (x < 0 || x >= Width || y < 0 || y >= Height) return;
+        draw_[y * Width + x] = c;
+        touched_.set(y);
+    }
+    uint16_t get(int x, int y) const { return draw_[y * Width + x]; }
+    // Row y of the draw buffer for writing a whole row at once
+    uint16_t* drawRow(int y) {
+        touched_.set(y);
+        return draw_ + y * Width;
+    }
+
+    void fill(uint16_t c) {
+        touched_.setAll();
+        if (c == 0) { memset(draw_, 0, BYTES); return; }
+        for (size_t i = 0; i < PIXELS; ++i) draw_[i] = c;
+    }
+    void blit(const uint16_t* src) {
+        touched_.setAll();
+        memcpy(draw_, src, BYTES);
+    }
+
+    // Flip buffers and call push(const uint16_t* frame, const uint16_t* previous,
+    // const Rows& dirty) when at least one row changed. Returns false (and
+    // pushes nothing) when the drawn frame is identical to the shown one.
+    template <typename Push>
+    bool present(Push&& push) {
+        Rows dirty;
+        for (int y = 0; y < Height; ++y) {
+            if (touched_.test(y) && memcmp(draw_ + y * Width, shown_ + y * Width, Width * sizeof(uint16_t)) != 0) dirty.set(y);
+        }
+        touched_.clear();
+        if (!dirty.any()) {
+            ++skipped_;
+            return false;
+        }
+        uint16_t* t = shown_;
+        shown_ = draw_;
+        draw_ = t;
+        push((const uint16_t*)shown_, (const uint16_t*)draw_, (const Rows&)dirty);
+        // The old frame differs from the new one only in the dirty rows
+        for (int y = 0; y < Height; ++y) {
+            if (dirty.test(y)) memcpy(draw_ + y * Width, shown_ + y * Width, Width * sizeof(uint16_t));
+        }
+        ++frames_;
+        return true;
+    }
+
+    uint32_t frames() const { return frames_; }
+    uint32_t skipped() const { return skipped_; }
+
+private:
+    uint16_t a_[PIXELS] = {};
+    uint16_t b_[PIXELS] = {};
+    uint16_t* draw_ = a_;
+    uint16_t* shown_ = b_;
+    Rows touched_;
+    uint32_t frames_ = 0;
+    uint32_t skipped_ = 0;
+};
+
+} // namespace Monalith
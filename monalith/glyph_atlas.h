@@ -0,0 +1,149 @@
+#pragma once
+
+// glyph_atlas.h - 8x8 1-bpp font for the Monalith annotation layer: note
+// letters A-G, accidentals, the octave digits and '-', and four arrows. At
+// compile time each glyph is converted into horizontal spans of lit pixels,
+// already scaled, so drawing text is one span fill per run of pixels instead
+// of a bit test and scale x scale pixel writes per font bit. Only the scales
+// that are actually drawn (SPANS<Scale>) end up in flash.
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace Monalith {
+namespace Glyphs {
+
+constexpr int SIZE = 8;   // glyph cell is SIZE x SIZE font pixels
+
+enum Glyph : uint8_t {
+    G_A, G_B, G_C, G_D, G_E, G_F, G_G,
+    G_SHARP, G_FLAT, G_NATURAL, G_MINUS,
+    G_0, G_1, G_2, G_3, G_4, G_5, G_6, G_7, G_8, G_9,
+    G_UP, G_DOWN, G_LEFT, G_RIGHT,
+    COUNT,
+    NONE = 0xFF,
+};
+
+// One row per byte, most significant bit leftmost
+constexpr uint8_t FONT[COUNT][SIZE] = {
+    {0x3C, 0x66, 0xC3, 0xC3, 0xFF, 0xC3, 0xC3, 0xC3},   // A
+    {0xFC, 0xC6, 0xC6, 0xFC, 0xC6, 0xC6, 0xC6, 0xFC},   // B
+    {0x3C, 0x66, 0xC0, 0xC0, 0xC0, 0xC0, 0x66, 0x3C},   // C
+    {0xF8, 0xCC, 0xC6, 0xC6, 0xC6, 0xC6, 0xCC, 0xF8},   // D
+    {0xFE, 0xC0, 0xC0, 0xFC, 0xC0, 0xC0, 0xC0, 0xFE},   // E
+    {0xFE, 0xC0, 0xC0, 0xFC, 0xC0, 0xC0, 0xC0, 0xC0},   // F
+    {0x3C, 0x66, 0xC0, 0xC0, 0xCE, 0xC6, 0x66, 0x3E},   // G
+    {0x12, 0x12, 0xFF, 0x12, 0x12, 0xFF, 0x12, 0x12},   // #
+    {0xC0, 0xC0, 0xC0, 0xFC, 0xC6, 0xC6, 0xC6, 0xFC},   // b (flat)
+    {0xC0, 0xC0, 0xC6, 0xFE, 0xC6, 0xFE, 0x06, 0x06},   // natural
+    {0x00, 0x00, 0x00, 0x7E, 0x7E, 0x00, 0x00, 0x00},   // -
+    {0x3C, 0x66, 0xC3, 0xC3, 0xC3, 0xC3, 0x66, 0x3C},   // 0
+    {0x18, 0x38, 0x78, 0x18, 0x18, 0x18, 0x18, 0x7E},   // 1
+    {0x3C, 0x66, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x7E},   // 2
+    {0x3C, 0x66, 0x06, 0x1C, 0x06, 0x06, 0x66, 0x3C},   // 3
+    {0x0C, 0x1C, 0x3C, 0x6C, 0xCC, 0xFE, 0x0C, 0x0C},   // 4
+    {0x7E, 0x60, 0x60, 0x7C, 0x06, 0x06, 0x66, 0x3C},   // 5
+    {0x3C, 0x66, 0x60, 0x7C, 0x66, 0x66, 0x66, 0x3C},   // 6
+    {0x7E, 0x06, 0x0C, 0x18, 0x30, 0x30, 0x30, 0x30},   // 7
+    {0x3C, 0x66, 0x66, 0x3C, 0x66, 0x66, 0x66, 0x3C},   // 8
+    {0x3C, 0x66, 0x66, 0x66, 0x3E, 0x06, 0x66, 0x3C},   // 9
+    {0x18, 0x3C, 0x7E, 0xDB, 0x18, 0x18, 0x18, 0x18},   // up arrow
+    {0x18, 0x18, 0x18, 0x18, 0xDB, 0x7E, 0x3C, 0x18},   // down arrow
+    {0x10, 0x30, 0x60, 0xFF, 0xFF, 0x60, 0x30, 0x10},   // left arrow
+    {0x08, 0x0C, 0x06, 0xFF, 0xFF, 0x06, 0x0C, 0x08},   // right arrow
+};
+
+// Character -> glyph: 'A'-'G', '#', 'b' (flat), 'n' (natural), '-', '0'-'9'
+// and '^' 'v' '<' '>' for the arrows. Anything else has no glyph.
+constexpr Glyph forChar(char c) {
+    if (c >= 'A' && c <= 'G') return (Glyph)(G_A + (c - 'A'));
+    if (c >= '0' && c <= '9') return (Glyph)(G_0 + (c - '0'));
+    switch (c) {
+        case '#': return G_SHARP;
+        case 'b': return G_FLAT;
+        case 'n': return G_NATURAL;
+        case '-': return G_MINUS;
+        case '^': return G_UP;
+        case 'v': return G_DOWN;
+        case '<': return G_LEFT;
+        case '>': return G_RIGHT;
+        default: return NONE;
+    }
+}
+
+// A run of lit pixels relative to the glyph's top-left corner
+struct Span {
+    uint8_t x;
+    uint8_t y;
+    uint8_t len;
+};
+
+constexpr int runsInRow(uint8_t bits) {
+    int runs = 0;
+    bool lit = false;
+    for (int b = 7; b >= 0; --b) {
+        bool on = (bits >> b) & 1;
+        if (on && !lit) ++runs;
+        lit = on;
+    }
+    return runs;
+}
+
+constexpr int fontRuns() {
+    int n = 0;
+    for (int g = 0; g < COUNT; ++g)
+        for (int y = 0; y < SIZE; ++y) n += runsInRow(FONT[g][y]);
+    return n;
+}
+
+// Every glyph as spans at `Scale`: each font row's runs, widened by Scale
+// and repeated on Scale panel rows. Glyph g owns spans [first[g], first[g + 1]).
+template <int Scale>
+struct SpanTable {
+    static_assert(Scale >= 1 && Scale * SIZE <= 255, "scale out of range");
+    static constexpr int TOTAL = fontRuns() * Scale;
+    uint16_t first[COUNT + 1];
+    Span span[TOTAL];
+};
+
+template <int Scale>
+constexpr SpanTable<Scale> makeSpans() {
+    SpanTable<Scale> t{};
+    int n = 0;
+    for (int g = 0; g < COUNT; ++g) {
+        t.first[g] = (uint16_t)n;
+        for (int y = 0; y < SIZE; ++y) {
+            uint8_t bits = FONT[g][y];
+            for (int x = 0; x < SIZE;) {
+                if (!((bits >> (7 - x)) & 1)) { ++x; continue; }
+                int start = x;
+                while (x < SIZE && ((bits >> (7 - x)) & 1)) ++x;
+                for (int sy = 0; sy < Scale; ++sy) {
+                    t.span[n++] = Span{(uint8_t)(start * Scale), (uint8_t)(y * Scale + sy), (uint8_t)((x - start) * Scale)};
+                }
+            }
+        }
+    }
+    t.first[COUNT] = (uint16_t)n;
+    return t;
+}
+
+template <int Scale>
+inline constexpr SpanTable<Scale> SPANS = makeSpans<Scale>();
+
+// Blit glyph g at (x0, y0) by handing each span to fill(x, y, len)
+template <int Scale, typename Fill>
+inline void blit(Glyph g, int x0, int y0, Fill&& fill) {
+    if (g >= COUNT) return;
+    const auto& t = SPANS<Scale>;
+    for (int i = t.first[g]; i < t.first[g + 1]; ++i) {
+        const Span& s = t.span[i];
+        fill(x0 + s.x, y0 + s.y, (int)s.len);
+    }
+}
+
+static_assert(forChar('C') == G_C && forChar('#') == G_SHARP && forChar('9') == G_9, "glyph map");
+static_assert(SPANS<1>.first[COUNT] == fontRuns(), "span count");
+
+} // namespace Glyphs
+} // namespace Monalith
@@ -1,37 +1,60 @@
 #include "monalith.h"
+#if defined(ARDUINO)
 #include <Arduino.h>
+#endif
 #include <cstdio>
 #include <cstdint>
 #include <cstring>
-#include <vector>
 #include <algorithm>
 
-// If compiling for Arduino/ESP32, attempt to use FastLED. Otherwise remain a host stub.
-#if defined(ARDUINO) && defined(ESP32)
-#include <FastLED.h>
-#define MONALITH_HAS_FASTLED 1
-#else
-#define MONALITH_HAS_FASTLED 0
+// Display driver, chosen at compile time with MONALITH_BACKEND (see backend.h)
+#include "backend.h"
+
+// Animation timing reads the shared firmware clock so host tests can run it in virtual time.
+#include "../src/clock.h"
+// Per-note LED index and colour come from compile-time tables
+#include "../src/note_tables.h"
+#include "palette.h"
+#include "voice_pool.h"
+#include "framebuffer.h"
+#include "compositor.h"
+#include "glyph_atlas.h"
+
+// Maximum simultaneously animated notes; further notes steal a voice
+#ifndef MONALITH_MAX_VOICES
+#define MONALITH_MAX_VOICES 32
 #endif
-
-// Force PxMatrix for HUB75 panels by default so no extra compile flags are required.
-#ifndef USE_PXMATRIX
-#define USE_PXMATRIX 1
+// Trail animation advances in fixed steps of elapsed time, independent of how
+// often tick() is called. A stall longer than MAX_SIM_STEPS steps is dropped.
+#ifndef MONALITH_SIM_STEP_US
+#define MONALITH_SIM_STEP_US 10000
 #endif
-// Optional HUB75 parallel panel support via PxMatrix. Enable with -DUSE_PXMATRIX
-#if defined(USE_PXMATRIX)
-#if defined(ESP32)
-#include <driver/gpio.h>
-#include <soc/gpio_struct.h>
+#ifndef MONALITH_MAX_SIM_STEPS
+#define MONALITH_MAX_SIM_STEPS 32
 #endif
-#include <PxMatrix.h>
-#define MONALITH_HAS_PXMATRIX 1
-#else
-#define MONALITH_HAS_PXMATRIX 0
+// Run the panel self-test (startSelfTest()) from showStaticBitmap() at boot
+#ifndef MONALITH_BOOT_SELF_TEST
+#define MONALITH_BOOT_SELF_TEST 0
+#endif
+// Self-test step lengths: opening white hold, each colour fill, each swept row
+#ifndef MONALITH_SELF_TEST_HOLD_MS
+#define MONALITH_SELF_TEST_HOLD_MS 10000
+#endif
+#ifndef MONALITH_SELF_TEST_COLOUR_MS
+#define MONALITH_SELF_TEST_COLOUR_MS 3000
+#endif
+#ifndef MONALITH_SELF_TEST_ROW_MS
+#define MONALITH_SELF_TEST_ROW_MS 200
+#endif
+// Print every showNote()/releaseNote() on host builds; benchmarks turn it off
+// so stdio stays out of the measured render path
+#ifndef MONALITH_NOTE_TRACE
+#define MONALITH_NOTE_TRACE (MONALITH_BACKEND == MONALITH_BACKEND_HOST)
+#endif
+// Default render rate cap; change at runtime with setTargetFps()
+#ifndef MONALITH_TARGET_FPS
+#define MONALITH_TARGET_FPS 60
 #endif
-
-// Forward-declare millis() for host builds; main.cpp provides a host stub when not on ESP32.
-extern uint32_t millis();
 
 namespace Monalith {
 
@@ -40,168 +63,238 @@ namespace Monalith {
 static const int WIDTH = 64;
 static const int HEIGHT = 64;
 static const int NUM_LEDS = WIDTH * HEIGHT; // 4096
-#if MONALITH_HAS_FASTLED
-// forward-declare xyToIndex for functions defined earlier that use it
-static int xyToIndex(int x, int y);
-#endif
-#if MONALITH_HAS_FASTLED
-// Default pin, change if your wiring uses a different GPIO
-static const int LED_PIN = 5;
-static CRGB leds[NUM_LEDS];
-#endif
+using PanelTables = NoteTables::Panel<WIDTH, HEIGHT>;
+
+// Presentation counters; pixels per second is measured over one-second windows
+static PresentStats stats = {};
+static uint32_t statsWindowStart = 0;
+static uint64_t statsWindowPixels = 0;
+
+static void countPresented(uint32_t pixels) {
+    ++stats.framesPresented;
+    stats.pixelsPushed += pixels;
+    statsWindowPixels += pixels;
+}
+
+static void countSkipped() { ++stats.framesSkipped; }
 
-#if MONALITH_HAS_PXMATRIX
-#define P_R1_PIN 25
-#define P_G1_PIN 26
-#define P_B1_PIN 27
-#define P_R2_PIN 14
-#define P_G2_PIN 12
-#define P_B2_PIN 13
-#define P_E_PIN 32
-#define P_A_PIN 23
-#define P_B_PIN 19
-#define P_C_PIN 5
-#define P_D_PIN 17
-#define P_CLK_PIN 16
-#define P_LAT_PIN 4
-#define P_OE_PIN 15
-
-// Include P_E_PIN when constructing PxMATRIX in case the panel requires 5 address lines
-static PxMATRIX matrix(WIDTH, HEIGHT, P_LAT_PIN, P_OE_PIN, P_A_PIN, P_B_PIN, P_C_PIN, P_D_PIN, P_E_PIN);
+PresentStats presentStats() { return stats; }
+const char* backendName() { return Backend<WIDTH, HEIGHT>::NAME; }
+void resetPresentStats() {
+    stats = PresentStats{};
+    statsWindowStart = Clock::nowMs();
+    statsWindowPixels = 0;
+}
+
+// All drawing goes to the canvas back buffer; present() flips it and hands
+// the panel only the spans that changed since the previous frame.
+static FrameBuffer565<WIDTH, HEIGHT> canvas;
+static Backend<WIDTH, HEIGHT> panel;
+// Background, note and annotation layers; composing rebuilds only their dirty rows
+static Compositor<WIDTH, HEIGHT> layers;
+
+// Set while the self-test or demo paints the canvas directly; the layers are
+// still kept up to date but not composed.
+static bool panelOverridden = false;
+// Set by the first note since init() until a frame showing it is presented
+static bool firstNotePending = false;
+static uint32_t firstNoteAtMs = 0;
+
+static void present() {
+    bool shown = canvas.present([](const uint16_t* frame, const uint16_t* prev, const FrameBuffer565<WIDTH, HEIGHT>::Rows& dirty) {
+        uint32_t pushed = 0;
+        if (dirty.count() == HEIGHT) {
+            panel.blit(frame);
+            pushed = NUM_LEDS;
+        } else {
+            for (int y = 0; y < HEIGHT; ++y) {
+                if (!dirty.test(y)) continue;
+                const uint16_t* row = frame + y * WIDTH;
+                const uint16_t* old = prev + y * WIDTH;
+                // push each run of changed pixels as one span
+                for (int x = 0; x < WIDTH;) {
+                    if (row[x] == old[x]) { ++x; continue; }
+                    int start = x;
+                    while (x < WIDTH && row[x] != old[x]) ++x;
+                    panel.drawSpan(start, y, row + start, x - start);
+                    pushed += (uint32_t)(x - start);
+                }
+            }
+        }
+        panel.present();
+        countPresented(pushed);
+    });
+    if (!shown) countSkipped();
+    // Self-test and demo frames cover the notes; the first frame composed
+    // from the layers after a note is the one that puts it on the panel
+    if (firstNotePending && shown && !panelOverridden) {
+        firstNotePending = false;
+        uint32_t now = Clock::nowMs();
+        firstNoteAtMs = now ? now : 1;
+    }
+}
+
+#if MONALITH_BACKEND == MONALITH_BACKEND_HOST
+const uint16_t* hostFramebuffer() { return panel.frame(); }
 #endif
 
-// Static bitmap storage and display-state (defined here so Arduino build links them)
-static bool staticBitmapActive = false;
-static uint16_t staticBitmapBuf[WIDTH * HEIGHT];
+// Display state (defined here so Arduino build links it)
 static DisplayState currentDisplayState = DisplayState::Normal;
+// Set whenever an active note's pixels have changed; tick() redraws the note
+// layer only while it is set.
+static bool sceneDirty = true;
+
+void showStaticBitmapFast(const uint16_t* bitmap) {
+    if (!bitmap) return;
+    // The bitmap becomes the cached background layer; notes stay on top
+    layers.setBackground(bitmap);
+    if (panelOverridden) return;
+    layers.compose(canvas);
+    present();
+}
 
 void showStaticBitmap(const uint16_t* bitmap) {
     if (!bitmap) return;
-    std::memcpy(staticBitmapBuf, bitmap, sizeof(staticBitmapBuf));
-    staticBitmapActive = true;
-#if defined(USE_PXMATRIX)
-    // Immediately perform a bright full-panel white draw so users can verify the
-    // panel is powered and responsive. Then blit the provided bitmap to the
-    // framebuffer and present it.
-    matrix.setBrightness(255);
-    for (int y = 0; y < HEIGHT; ++y) {
-        for (int x = 0; x < WIDTH; ++x) {
-            matrix.drawPixel(x, y, 0xFFFF);
-        }
-    }
-    matrix.display();
-    delay(10000);
-    // Color-channel visibility test: red, green, blue, white (3s each)
-    const uint16_t COL_RED = 0xF800;
-    const uint16_t COL_GREEN = 0x07E0;
-    const uint16_t COL_BLUE = 0x001F;
-    const uint16_t COL_WHITE = 0xFFFF;
-    std::puts("Monalith: starting color-channel test: RED/GREEN/BLUE/WHITE");
-    uint16_t colors[] = {COL_RED, COL_GREEN, COL_BLUE, COL_WHITE};
-    for (uint16_t c : colors) {
-        matrix.clearDisplay();
-        for (int y = 0; y < HEIGHT; ++y) for (int x = 0; x < WIDTH; ++x) matrix.drawPixel(x, y, c);
-        matrix.display();
-        if (c == COL_RED) std::puts("Monalith: COLOR TEST red");
-        else if (c == COL_GREEN) std::puts("Monalith: COLOR TEST green");
-        else if (c == COL_BLUE) std::puts("Monalith: COLOR TEST blue");
-        else std::puts("Monalith: COLOR TEST white");
-        delay(3000);
-    }
-    // Slower row-sweep diagnostic: light each row red and print the row index (200ms per row)
-    for (int y = 0; y < HEIGHT; ++y) {
-        matrix.clearDisplay();
-        for (int x = 0; x < WIDTH; ++x) {
-            matrix.drawPixel(x, y, COL_RED); // red (RGB565)
-        }
-        matrix.display();
-        std::printf("Monalith: row-sweep row=%d\n", y);
-        delay(200);
-    }
-    // Blit the copied bitmap immediately after the diagnostic
-    for (int y = 0; y < HEIGHT; ++y) {
-        for (int x = 0; x < WIDTH; ++x) {
-            int idx = y * WIDTH + x;
-            uint16_t c = staticBitmapBuf[idx];
-            matrix.drawPixel(x, y, c);
-        }
-    }
-    matrix.display();
-#endif
+    showStaticBitmapFast(bitmap);
     std::puts("Monalith: static bitmap enabled (library)");
+    // The panel wiring check runs from tick() and uncovers the bitmap when done
+    if (MONALITH_BOOT_SELF_TEST) startSelfTest();
+}
+
+bool showStaticOverlay(const OverlayAsset& overlay) {
+    bool ok = overlay.width == WIDTH && overlay.height == HEIGHT &&
+              Overlay::decode(overlay, layers.editBackground(), WIDTH);
+    if (!ok) layers.setBackground(nullptr);
+    if (!panelOverridden) {
+        layers.compose(canvas);
+        present();
+    }
+    if (!ok) return false;
+    std::puts("Monalith: static overlay enabled (library)");
+    if (MONALITH_BOOT_SELF_TEST) startSelfTest();
+    return true;
 }
 
 void clearStaticBitmap() {
-    staticBitmapActive = false;
-#if defined(USE_PXMATRIX)
-    for (int y = 0; y < HEIGHT; ++y) for (int x = 0; x < WIDTH; ++x) matrix.drawPixel(x, y, 0);
-    matrix.display();
-#endif
+    layers.setBackground(nullptr);
+    if (panelOverridden) return;
+    layers.compose(canvas);
+    present();
 }
 
 void setDisplayState(DisplayState s) { currentDisplayState = s; }
 DisplayState getDisplayState() { return currentDisplayState; }
 
-// Extended active note: support velocity (0-127) and a trail intensity
-struct ActiveNote { int idx; uint8_t hue; uint8_t vel; uint32_t expire_ms; uint8_t trail_level; };
-static std::vector<ActiveNote> activeNotes;
+// Active notes: velocity (0-127), a trail intensity that decays in tick(), and
+// `held` for notes from a streamed NoteOn that stay lit until releaseNote().
+// Fixed-capacity pool, so showNote()/tick() never touch the heap.
+static VoicePool<MONALITH_MAX_VOICES> voices;
+
+void setVoiceStealPolicy(VoiceSteal policy) { voices.setPolicy(policy); }
+size_t activeVoiceCount() { return voices.size(); }
+uint32_t stolenVoiceCount() { return voices.stolen(); }
+// Fixed-timestep scheduler: simulation time already consumed, the next frame
+// slot, and its statistics
+static bool schedStarted = false;
+static uint64_t simTimeUs = 0;
+static uint64_t nextFrameUs = 0;
+static uint32_t frameUs = 1000000 / MONALITH_TARGET_FPS;
+static uint16_t fpsTarget = MONALITH_TARGET_FPS;
+static SchedulerStats sched = {};
+
+void setTargetFps(uint16_t fps) {
+    fpsTarget = fps;
+    frameUs = fps ? 1000000u / fps : 0;
+}
+uint16_t targetFps() { return fpsTarget; }
+uint32_t framePeriodUs() { return frameUs; }
+SchedulerStats schedulerStats() { return sched; }
+void resetSchedulerStats() { sched = SchedulerStats{}; }
 // Demo blink state (non-blocking): when demo_end_ms != 0, tick() will toggle full-panel
 static uint32_t demo_end_ms = 0;
 static uint32_t demo_next_toggle = 0;
 static bool demo_on = false;
-// Glyph display state
+// Glyph display state: the glyph stays on the annotation layer until glyph_end_ms
 static uint32_t glyph_end_ms = 0;
 static bool glyph_active = false;
-static int glyph_x0 = 0;
-static int glyph_y0 = 0;
-static int glyph_scale = 1;
-static uint16_t glyph_c_color = 0xF800; // red default
-static uint16_t glyph_hash_color = 0xFFFF; // white default
-static bool glyph_printed_map = false;
+// Note name label: top-left corner, newest active note, in its own colour
+static const uint8_t NO_LABEL = 0xFF;
+static bool noteNamesOn = false;
+static uint8_t labelNote = NO_LABEL;
+
+// Panel self-test: a white hold, red/green/blue/white fills, then a red row
+// sweep, one step per tick() once the previous step's time is up. Step 0 is
+// the hold, 1..4 the colours and 5.. the rows; -1 when not running.
+static const uint16_t SELF_TEST_COLOURS[] = {0xF800, 0x07E0, 0x001F, 0xFFFF};
+static const char* const SELF_TEST_NAMES[] = {"red", "green", "blue", "white"};
+static const int SELF_TEST_STEPS = 1 + 4 + HEIGHT;
+static int selfTestStep = -1;
+static uint32_t selfTestNextMs = 0;
+
+static void drawSelfTestStep(int step, uint32_t now) {
+    if (step == 0) {
+        canvas.fill(0xFFFF);
+        selfTestNextMs = now + MONALITH_SELF_TEST_HOLD_MS;
+        std::puts("Monalith: self-test white hold");
+    } else if (step <= 4) {
+        canvas.fill(SELF_TEST_COLOURS[step - 1]);
+        selfTestNextMs = now + MONALITH_SELF_TEST_COLOUR_MS;
+        std::printf("Monalith: COLOR TEST %s\n", SELF_TEST_NAMES[step - 1]);
+    } else {
+        int y = step - 5;
+        canvas.fill(0);
+        for (int x = 0; x < WIDTH; ++x) canvas.set(x, y, 0xF800);
+        selfTestNextMs = now + MONALITH_SELF_TEST_ROW_MS;
+        std::printf("Monalith: row-sweep row=%d\n", y);
+    }
+    present();
+}
+
+void startSelfTest() {
+    selfTestStep = 0;
+    panelOverridden = true;
+    drawSelfTestStep(0, Clock::nowMs());
+}
+
+bool selfTestActive() { return selfTestStep >= 0; }
+
+// Move to the next step when the current one is over; past the last step the
+// normal frame is recomposed
+static void advanceSelfTest(uint32_t now) {
+    if ((int32_t)(selfTestNextMs - now) > 0) return;
+    if (++selfTestStep < SELF_TEST_STEPS) {
+        drawSelfTestStep(selfTestStep, now);
+        return;
+    }
+    selfTestStep = -1;
+    panelOverridden = false;
+    layers.invalidate();
+    std::puts("Monalith: self-test done");
+}
+
+uint32_t firstNoteMs() { return firstNoteAtMs; }
 
 // NOTE: forceHardwareWhite removed — white hardware test disabled per user request.
 
 bool init() {
-    // Initialize available backends. If both FastLED and PxMatrix are compiled in,
-    // initialize both so showNote/tick can safely use either path.
-#if MONALITH_HAS_FASTLED
-    FastLED.addLeds<NEOPIXEL, LED_PIN>(leds, NUM_LEDS);
-    FastLED.clear();
-    FastLED.show();
-    std::puts("Monalith: FastLED initialized");
-#endif
-#if MONALITH_HAS_PXMATRIX
-    // Force-panel control pins to outputs early to avoid external dongles
-    // holding strapping lines and disabling the panel
-    pinMode(P_OE_PIN, OUTPUT);
-    pinMode(P_LAT_PIN, OUTPUT);
-    pinMode(P_CLK_PIN, OUTPUT);
-    // Drive OE low (enable output), toggle LAT and CLK to a known state
-    digitalWrite(P_OE_PIN, LOW); // enable panel
-    digitalWrite(P_LAT_PIN, HIGH);
-    digitalWrite(P_LAT_PIN, LOW);
-    digitalWrite(P_CLK_PIN, LOW);
-    std::printf("Monalith: forced OE=%d LAT=%d CLK=%d\n", digitalRead(P_OE_PIN), digitalRead(P_LAT_PIN), digitalRead(P_CLK_PIN));
-
-    // initialize PxMatrix frame buffer and set reasonable brightness
-    // Provide explicit row scan. Most 64x64 HUB75 panels are 1/32 scan —
-    // use 32 here. If your panel is different, change the first argument
-    // accordingly (e.g., 8 or 16). PxMatrix begin() signatures vary by
-    // library version; use the single-arg form here for portability.
-    matrix.begin(32);
-    matrix.setBrightness(50);
-    matrix.clearDisplay();
-    matrix.display();
-    std::puts("Monalith: PxMatrix (HUB75) initialized");
-    // Print configured pin mapping for verification
-    std::printf("Monalith: PxMatrix pins LAT=%d OE=%d A=%d B=%d C=%d D=%d CLK=%d R1=%d G1=%d B1=%d R2=%d G2=%d B2=%d E=%d\n",
-                P_LAT_PIN, P_OE_PIN, P_A_PIN, P_B_PIN, P_C_PIN, P_D_PIN, P_CLK_PIN,
-                P_R1_PIN, P_G1_PIN, P_B1_PIN, P_R2_PIN, P_G2_PIN, P_B2_PIN, P_E_PIN);
-#endif
-#if !MONALITH_HAS_FASTLED && !MONALITH_HAS_PXMATRIX
-    std::puts("Monalith: init (host stub)");
-#endif
-    activeNotes.clear();
+    if (!panel.begin()) {
+        std::printf("Monalith: %s backend failed to start\n", Backend<WIDTH, HEIGHT>::NAME);
+        return false;
+    }
+    std::printf("Monalith: %s backend initialized\n", Backend<WIDTH, HEIGHT>::NAME);
+    voices.clear();
+    layers.clear(Layer::Notes);
+    sceneDirty = true;
+    schedStarted = false;
+    selfTestStep = -1;
+    panelOverridden = false;
+    firstNoteAtMs = 0;
+    firstNotePending = false;
+    labelNote = NO_LABEL;
+    glyph_active = false;
+    layers.clear(Layer::Annotations);
+    resetPresentStats();
+    resetSchedulerStats();
     return true;
 }
 
@@ -213,302 +306,267 @@ void visualizeDemoSafe(uint32_t /*ms*/) {
     // Intentionally left empty to preserve existing API but avoid test patterns.
 }
 
-// Simple 8x8 bitmaps for 'C' and '#'
-static const uint8_t GLYPH_C[8] = {
-    0b00111100,
-    0b01100110,
-    0b11000000,
-    0b11000000,
-    0b11000000,
-    0b11000000,
-    0b01100110,
-    0b00111100
-};
-
-static const uint8_t GLYPH_HASH[8] = {
-    0b00010010,
-    0b00010010,
-    0b11111111,
-    0b00010010,
-    0b00010010,
-    0b11111111,
-    0b00010010,
-    0b00010010
-};
-
-// convert 16-bit 565 color to 8-bit RGB
-static void color565_to_rgb(uint16_t c565, uint8_t &r, uint8_t &g, uint8_t &b) {
-    uint8_t r5 = (c565 >> 11) & 0x1F;
-    uint8_t g6 = (c565 >> 5) & 0x3F;
-    uint8_t b5 = c565 & 0x1F;
-    r = (r5 << 3) | (r5 >> 2);
-    g = (g6 << 2) | (g6 >> 4);
-    b = (b5 << 3) | (b5 >> 2);
+// Write `text` from the glyph atlas at (x0, y0) into the annotation layer, one
+// span fill per run of lit pixels. Returns the x just past the last glyph.
+template <int Scale>
+static int drawText(int x0, int y0, const char* text, uint16_t colour565, int gap = 0) {
+    for (const char* c = text; *c; ++c) {
+        Glyphs::blit<Scale>(Glyphs::forChar(*c), x0, y0, [&](int x, int y, int n) {
+            layers.fillSpan(Layer::Annotations, x, y, n, colour565);
+        });
+        x0 += (Glyphs::SIZE + gap) * Scale;
+    }
+    return x0;
 }
 
-// Draw an 8x8 glyph scaled by `scale` (each glyph pixel becomes scale x scale block)
-void drawGlyphAt(int x0, int y0, const uint8_t *glyph, uint16_t color565, int scale=1, bool print_map=false) {
-    for (int gy = 0; gy < 8; ++gy) {
-        for (int gx = 0; gx < 8; ++gx) {
-            if (!(glyph[gy] & (1 << (7 - gx)))) continue;
-            // draw a scale x scale block
-            for (int sy = 0; sy < scale; ++sy) {
-                for (int sx = 0; sx < scale; ++sx) {
-                    int px = x0 + gx * scale + sx;
-                    int py = y0 + gy * scale + sy;
-#if MONALITH_HAS_PXMATRIX
-                    matrix.drawPixel(px, py, color565);
-#elif MONALITH_HAS_FASTLED
-                    int idx = xyToIndex(px, py);
-                    if (idx >= 0 && idx < NUM_LEDS) {
-                        uint8_t rr,gg,bb; color565_to_rgb(color565, rr, gg, bb);
-                        leds[idx] = CRGB(rr,gg,bb);
-                    }
-#endif
-                    if (print_map) {
-                        int idx = xyToIndex(px, py);
-                        Serial.printf("MAP px=%d py=%d -> idx=%d\n", px, py, idx);
-                    }
-                }
-            }
-        }
+// Red 'C' and white '#', 16x16 each, centred on the panel
+static void drawCSharpGlyphs() {
+    const int scale = 2;
+    const int glyphW = Glyphs::SIZE * scale;
+    const int gap = 2 * scale;
+    int x0 = (WIDTH - (glyphW + gap + glyphW)) / 2;
+    int y0 = (HEIGHT - glyphW) / 2;
+    drawText<scale>(x0, y0, "C", 0xF800);
+    drawText<scale>(x0 + glyphW + gap, y0, "#", 0xFFFF);
+}
+
+// Rebuild the annotation layer from the glyph and the note name label
+static void drawAnnotations() {
+    layers.clear(Layer::Annotations);
+    if (glyph_active) drawCSharpGlyphs();
+    if (labelNote != NO_LABEL) {
+        drawText<1>(1, 1, NoteTables::NAME[labelNote].s, Palette::RGB565[Palette::row(labelNote)][255], 1);
     }
 }
+
+void showNoteNames(bool on) { noteNamesOn = on; }
+
 void drawCSharp(uint32_t ms) {
     // schedule glyph display for ms milliseconds and draw immediately
-    uint32_t now = millis();
-    glyph_end_ms = now + ms;
+    glyph_end_ms = Clock::nowMs() + ms;
     glyph_active = true;
-    glyph_printed_map = false;
-
-    // scale glyphs 2x to produce 16x16 each
-    int scale = 2;
-    int glyphW = 8 * scale;
-    int gap = 2 * scale;
-    int totalW = glyphW + gap + glyphW;
-    int x0 = (WIDTH - totalW) / 2;
-    int y0 = (HEIGHT - glyphW) / 2;
-    glyph_x0 = x0;
-    glyph_y0 = y0;
-    glyph_scale = scale;
-    glyph_c_color = 0xF800; // red
-    glyph_hash_color = 0xFFFF; // white
-
-    // initial draw (also print mapping once)
-#if MONALITH_HAS_PXMATRIX
-    matrix.clearDisplay();
-    drawGlyphAt(x0, y0, GLYPH_C, glyph_c_color, scale, true);
-    drawGlyphAt(x0 + glyphW + gap, y0, GLYPH_HASH, glyph_hash_color, scale, true);
-    matrix.display();
-#elif MONALITH_HAS_FASTLED
-    FastLED.clear();
-    drawGlyphAt(x0, y0, GLYPH_C, glyph_c_color, scale, true);
-    drawGlyphAt(x0 + glyphW + gap, y0, GLYPH_HASH, glyph_hash_color, scale, true);
-    FastLED.show();
-#endif
-    glyph_printed_map = true;
+    // the glyph goes over the notes and background
+    drawAnnotations();
+    if (panelOverridden) return;
+    layers.compose(canvas);
+    present();
 }
 
 // Map a piano MIDI note (21..108) to an LED index inside a WIDTH x HEIGHT matrix.
-static int xyToIndex(int x, int y) {
-    // serpentine mapping is common for LED matrices; assume row-major serpentine
-    if (x < 0) x = 0; if (x >= WIDTH) x = WIDTH - 1;
-    if (y < 0) y = 0; if (y >= HEIGHT) y = HEIGHT - 1;
-    if (y % 2 == 0) {
-        // even row left-to-right
-        return y * WIDTH + x;
-    } else {
-        // odd row right-to-left
-        return y * WIDTH + (WIDTH - 1 - x);
-    }
-}
-
-static int noteToIndex(uint8_t note) {
-    const int MIN_NOTE = 21;
-    const int MAX_NOTE = 108;
-    if (note < MIN_NOTE) note = MIN_NOTE;
-    if (note > MAX_NOTE) note = MAX_NOTE;
-    int range = MAX_NOTE - MIN_NOTE + 1; // 88
-    int rel = note - MIN_NOTE; // 0..87
-    // map across width
-    int x = (rel * WIDTH) / range;
-    // central vertical position (start in middle of height)
-    int y = HEIGHT / 2;
-    return xyToIndex(x, y);
-}
+static int noteToIndex(uint8_t note) { return PanelTables::LED_INDEX[note]; }
 
-// Convert note to hue (0-255)
-static uint8_t noteToHue(uint8_t note) {
-    return (uint8_t)((note % 12) * (256 / 12));
-}
+static void drawNoteCross(int idx, uint8_t colour, uint8_t level);
 
 // velocity: 0-127 influences brightness. duration_ms controls how long the note is held.
 // We'll also spawn lightweight 'trail' entries by setting trail_level which decays in tick().
 void showNote(uint8_t note, uint32_t duration_ms, uint8_t velocity) {
     int idx = noteToIndex(note);
-    uint8_t hue = noteToHue(note);
-    uint32_t now = millis();
+    uint8_t colour = Palette::row(note);
+    uint32_t now = Clock::nowMs();
+    bool held = duration_ms == DURATION_HELD;
     // Animation expiry: keep visual for at least duration_ms, clamp to reasonable max
     uint32_t dur = duration_ms == 0 ? 200 : std::min<uint32_t>(duration_ms, 8000);
     // Map velocity (0..127) -> brightness (30..255)
     uint8_t bri = (uint8_t)std::min<int>((velocity * 2) + 30, 255);
-    ActiveNote an{idx, hue, velocity, now + dur, bri};
-    activeNotes.push_back(an);
-
-    // Unified pixel setter: supports PxMatrix (HUB75) or FastLED strips
-    auto setPixelXY = [&](int px, int py, uint8_t h, uint8_t v){
-        if (px < 0 || px >= WIDTH) return;
-        if (py < 0 || py >= HEIGHT) return;
-#if MONALITH_HAS_PXMATRIX
-        // Convert HSV to RGB and send to PxMatrix (uses 16-bit color)
-        auto hsvToRgb = [](uint8_t H, uint8_t S, uint8_t V, uint8_t &r, uint8_t &g, uint8_t &b){
-            uint8_t region = H / 43;
-            uint8_t remainder = (H - (region * 43)) * 6;
-            uint8_t p = (V * (255 - S)) >> 8;
-            uint8_t q = (V * (255 - ((S * remainder) >> 8))) >> 8;
-            uint8_t t = (V * (255 - ((S * (255 - remainder)) >> 8))) >> 8;
-            switch(region) {
-                case 0: r = V; g = t; b = p; break;
-                case 1: r = q; g = V; b = p; break;
-                case 2: r = p; g = V; b = t; break;
-                case 3: r = p; g = q; b = V; break;
-                case 4: r = t; g = p; b = V; break;
-                default: r = V; g = p; b = q; break;
-            }
-        };
-        uint8_t r,g,b; hsvToRgb(h, 200, v, r, g, b);
-        uint16_t color565 = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
-        matrix.drawPixel(px, py, color565);
-#elif MONALITH_HAS_FASTLED
-        int ii = xyToIndex(px, py);
-        if (ii < 0 || ii >= NUM_LEDS) return;
-        CRGB color = CHSV(h, 200, v);
-        leds[ii] = blend(leds[ii], color, 192);
-#else
-        // host: no-op (debug printing elsewhere)
+    auto v = voices.allocate();
+    voices.idx[v] = (int16_t)idx;
+    voices.colour[v] = colour;
+    voices.vel[v] = velocity;
+    voices.note[v] = note;
+    voices.level[v] = bri;
+    voices.held[v] = held;
+    voices.start_ms[v] = now;
+    voices.expire_ms[v] = now + dur;
+    drawNoteCross(idx, colour, bri);
+    sceneDirty = true;
+    if (firstNoteAtMs == 0) firstNotePending = true;
+
+    // The cross is on the note layer; tick() composes and presents it with the rest of the frame
+#if MONALITH_NOTE_TRACE
+    std::printf("Monalith: showNote note=%u idx=%d hue=%u vel=%u dur=%u%s\n", note, idx, (unsigned)NoteTables::HUE[note], (unsigned)velocity, dur, held ? " (held)" : "");
+#endif
+}
+
+void releaseNote(uint8_t note) {
+    uint32_t now = Clock::nowMs();
+    for (size_t i = 0; i < voices.size(); ++i) {
+        auto v = voices.at(i);
+        if (!voices.held[v] || voices.note[v] != note) continue;
+        voices.held[v] = false;
+        voices.expire_ms[v] = now;
+    }
+#if MONALITH_NOTE_TRACE
+    std::printf("Monalith: releaseNote note=%u\n", note);
 #endif
+}
+
+// Plot a note's main pixel plus its chord spread at brightness `level` into
+// the note layer (level 0 is black, i.e. transparent).
+static void drawNoteCross(int idx, uint8_t colour, uint8_t level) {
+    const uint16_t* shade = Palette::RGB565[colour];
+    auto setPixelXY = [&](int px, int py, uint8_t v){
+        layers.set(Layer::Notes, px, py, shade[v]);
     };
 
     // Determine column/x,y for idx
     int main_x = (idx % WIDTH);
     int main_y = (idx / WIDTH);
-    setPixelXY(main_x, main_y, hue, an.trail_level);
+    setPixelXY(main_x, main_y, level);
     // chord spread: neighboring columns and a small vertical spread
-    setPixelXY(main_x - 1, main_y, hue, an.trail_level / 2);
-    setPixelXY(main_x + 1, main_y, hue, an.trail_level / 2);
-    setPixelXY(main_x, main_y - 1, hue, an.trail_level / 3);
-    setPixelXY(main_x, main_y + 1, hue, an.trail_level / 3);
-
-#if MONALITH_HAS_FASTLED
-    FastLED.show();
-#elif MONALITH_HAS_PXMATRIX
-    // For PxMatrix, we defer display() to tick() to allow batching; optionally call here for immediate update
-    // matrix.display();
-#else
-    std::printf("Monalith: showNote note=%u idx=%d hue=%u vel=%u dur=%u\n", note, idx, (unsigned)hue, (unsigned)velocity, dur);
-#endif
+    setPixelXY(main_x - 1, main_y, level / 2);
+    setPixelXY(main_x + 1, main_y, level / 2);
+    setPixelXY(main_x, main_y - 1, level / 3);
+    setPixelXY(main_x, main_y + 1, level / 3);
 }
 
-void tick() {
-    uint32_t now = millis();
+// One fixed simulation step: decay trail levels and free expired notes
+// (backwards: release() swaps the last voice in)
+static void stepVoices(uint32_t now) {
+    for (size_t i = voices.size(); i-- > 0;) {
+        auto v = voices.at(i);
+        // held notes stay at full brightness until released
+        if (voices.held[v]) continue;
+        // trail level decays over time
+        uint8_t& level = voices.level[v];
+        if (level != 0) sceneDirty = true;
+        if (level > 10) level = (uint8_t)(level * 3 / 4);
+        else level = 0;
+        if (level == 0 && (int32_t)(voices.expire_ms[v] - now) <= 0) {
+            voices.release(v);
+            sceneDirty = true;
+        }
+    }
+}
+
+// Most recently started active note, or NO_LABEL when none is sounding
+static uint8_t newestNote() {
+    uint8_t note = NO_LABEL;
+    uint32_t newest = 0;
+    for (size_t i = 0; i < voices.size(); ++i) {
+        auto v = voices.at(i);
+        if (note != NO_LABEL && (int32_t)(voices.start_ms[v] - newest) < 0) continue;
+        note = voices.note[v];
+        newest = voices.start_ms[v];
+    }
+    return note;
+}
+
+// Run every whole simulation step that has elapsed since the last call
+static void advanceSimulation(uint64_t nowUs, uint32_t now) {
+    uint64_t steps = (nowUs - simTimeUs) / MONALITH_SIM_STEP_US;
+    if (steps > MONALITH_MAX_SIM_STEPS) {
+        // Too far behind to catch up meaningfully (trails are long gone); skip ahead
+        sched.simStepsDropped += (uint32_t)(steps - MONALITH_MAX_SIM_STEPS);
+        simTimeUs += (steps - MONALITH_MAX_SIM_STEPS) * MONALITH_SIM_STEP_US;
+        steps = MONALITH_MAX_SIM_STEPS;
+    }
+    for (uint64_t i = 0; i < steps; ++i) stepVoices(now);
+    simTimeUs += steps * MONALITH_SIM_STEP_US;
+    sched.simSteps += (uint32_t)steps;
+}
+
+// True when a frame slot has come up; frame slots that passed while tick()
+// was not called count as missed.
+static bool frameDue(uint64_t nowUs) {
+    if (frameUs == 0) { ++sched.frames; return true; }
+    if ((int64_t)(nowUs - nextFrameUs) < 0) return false;
+    uint64_t late = nowUs - nextFrameUs;
+    uint64_t slots = late / frameUs;
+    sched.framesMissed += (uint32_t)slots;
+    if (late > sched.maxLateUs) sched.maxLateUs = (uint32_t)std::min<uint64_t>(late, UINT32_MAX);
+    nextFrameUs += (slots + 1) * frameUs;
+    ++sched.frames;
+    return true;
+}
+
+// Everything tick() does except keeping the panel lit
+static void update() {
+    uint64_t nowUs = Clock::nowUs();
+    uint32_t now = (uint32_t)(nowUs / 1000);
+    if (!schedStarted) {
+        schedStarted = true;
+        simTimeUs = nowUs;
+        nextFrameUs = nowUs;
+        statsWindowStart = now;
+    }
+    // Trails advance with elapsed time, also while the self-test or a demo covers them
+    advanceSimulation(nowUs, now);
+    uint32_t window = now - statsWindowStart;
+    if (window >= 1000) {
+        stats.pixelsPerSecond = (uint32_t)(statsWindowPixels * 1000 / window);
+        statsWindowStart = now;
+        statsWindowPixels = 0;
+    }
+    // The self-test owns the panel until its last step; notes keep animating underneath
+    if (selfTestStep >= 0) {
+        advanceSelfTest(now);
+        if (selfTestStep >= 0) return;
+    }
     // Handle non-blocking demo blink: 1Hz (toggle every 500ms)
     if (demo_end_ms != 0 && (int32_t)(demo_end_ms - now) > 0) {
+        panelOverridden = true;
         if ((int32_t)(demo_next_toggle - now) <= 0) {
             demo_on = !demo_on;
             demo_next_toggle = now + 500;
             // Render full on or clear depending on demo_on
-#if MONALITH_HAS_PXMATRIX
-            if (demo_on) {
-                uint16_t white = 0xFFFF;
-                for (int y = 0; y < HEIGHT; ++y) for (int x = 0; x < WIDTH; ++x) matrix.drawPixel(x, y, white);
-            } else {
-                matrix.clearDisplay();
-            }
-            matrix.display();
-#elif MONALITH_HAS_FASTLED
-            if (demo_on) {
-                for (int i = 0; i < NUM_LEDS; ++i) leds[i] = CRGB::White;
-            } else {
-                for (int i = 0; i < NUM_LEDS; ++i) leds[i] = CRGB::Black;
-            }
-            FastLED.show();
-#endif
+            canvas.fill(demo_on ? 0xFFFF : 0);
+            present();
         }
         return; // while demo active, skip normal rendering
     } else {
-        // demo finished; reset demo state
+        // demo finished; reset demo state and recompose the whole panel
+        if (demo_end_ms != 0) {
+            panelOverridden = false;
+            layers.invalidate();
+        }
         demo_end_ms = 0;
         demo_next_toggle = 0;
         demo_on = false;
     }
-    // If a glyph is active, redraw it every tick so it persists
-    if (glyph_active) {
-        if ((int32_t)(glyph_end_ms - now) <= 0) {
-            glyph_active = false;
-            // clear display when finished
-#if MONALITH_HAS_PXMATRIX
-            matrix.clearDisplay();
-            matrix.display();
-#elif MONALITH_HAS_FASTLED
-            FastLED.clear();
-            FastLED.show();
-#endif
-        } else {
-            // redraw glyph frame
-            int x0 = glyph_x0;
-            int y0 = glyph_y0;
-            int scale = glyph_scale;
-#if MONALITH_HAS_PXMATRIX
-            drawGlyphAt(x0, y0, GLYPH_C, glyph_c_color, scale, false);
-            drawGlyphAt(x0 + (8*scale) + (2*scale), y0, GLYPH_HASH, glyph_hash_color, scale, false);
-            matrix.display();
-#elif MONALITH_HAS_FASTLED
-            drawGlyphAt(x0, y0, GLYPH_C, glyph_c_color, scale, false);
-            drawGlyphAt(x0 + (8*scale) + (2*scale), y0, GLYPH_HASH, glyph_hash_color, scale, false);
-            FastLED.show();
-#endif
-        }
-        return; // skip normal rendering while glyph active
+    // The glyph sits on the annotation layer; when it expires only its rows are recomposed
+    bool annotationsChanged = false;
+    if (glyph_active && (int32_t)(glyph_end_ms - now) <= 0) {
+        glyph_active = false;
+        annotationsChanged = true;
     }
-    // Decay trail levels and remove expired notes
-    for (auto &a : activeNotes) {
-        // trail_level decays over time
-        if (a.trail_level > 10) a.trail_level = (uint8_t)(a.trail_level * 3 / 4);
-        else a.trail_level = 0;
+    // Render at most once per frame slot
+    if (!frameDue(nowUs)) {
+        if (annotationsChanged) drawAnnotations();
+        return;
     }
-    activeNotes.erase(std::remove_if(activeNotes.begin(), activeNotes.end(), [&](const ActiveNote& a){
-        return (int32_t)(a.expire_ms - now) <= 0 && a.trail_level == 0;
-    }), activeNotes.end());
-
-#if MONALITH_HAS_FASTLED
-    // Blue/white themed rendering with simple trail blending
-    FastLED.clear();
-    for (const auto &a : activeNotes) {
-        uint8_t v = a.trail_level;
-        // Convert base hue to a blue-white blend: lower hues -> bluer, high brightness -> white
-        CRGB col = CHSV(a.hue, 200, v);
-        // Convert very bright notes toward white to create blue/white palette
-        if (v > 180) {
-            // mix towards white
-            col = blend(col, CRGB::White, (uint8_t)(v - 160));
+    // Label the newest note; the spans are only redrawn when the label changes
+    uint8_t label = noteNamesOn ? newestNote() : NO_LABEL;
+    if (label != labelNote) {
+        labelNote = label;
+        annotationsChanged = true;
+    }
+    if (annotationsChanged) drawAnnotations();
+    // Redraw the note layer only when a note changed: its rows that held or
+    // now hold note pixels become dirty
+    if (sceneDirty) {
+        sceneDirty = false;
+        layers.clear(Layer::Notes);
+        for (size_t i = 0; i < voices.size(); ++i) {
+            auto v = voices.at(i);
+            drawNoteCross(voices.idx[v], voices.colour[v], voices.level[v]);
         }
-        // Place the main pixel
-        if (a.idx >= 0 && a.idx < NUM_LEDS) leds[a.idx] = blend(leds[a.idx], col, 220);
-        // soft spread for chords: neighbors get reduced intensity
-        int left = a.idx - 1; int right = a.idx + 1;
-        if (left >= 0) leds[left] = blend(leds[left], col, 120);
-        if (right < NUM_LEDS) leds[right] = blend(leds[right], col, 120);
     }
-    FastLED.show();
-#elif MONALITH_HAS_PXMATRIX
-    // For PxMatrix, we've plotted pixels during showNote; now present the framebuffer
-    matrix.display();
-#else
-    // host: print active notes for debugging
-    if (!activeNotes.empty()) {
-        std::printf("Monalith: active=%zu\n", activeNotes.size());
+    // Nothing moved since the last frame: skip composing and presenting it
+    if (!layers.dirty()) {
+        countSkipped();
+        return;
     }
-#endif
+    // Rebuild the dirty rows from background, notes and annotations and present once
+    layers.compose(canvas);
+    present();
+}
+
+void tick() {
+    update();
+    // Skipped frames skip only the pixel push: a CPU-scanned panel goes dark
+    // or stops on one row unless the backend refreshes on every pass
+    panel.refresh();
+    ++stats.panelRefreshes;
 }
 
 } // namespace Monalith
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
+#include "voice_pool.h"
+#include "../src/overlay_asset.h"
 
 namespace Monalith {
 
@@ -13,15 +16,63 @@ bool init();
 // Implementations should map note/duration to LED animations.
 void showNote(uint8_t note, uint32_t duration_ms, uint8_t velocity = 100);
 
+// Pass as `duration_ms` to keep a streamed note lit until releaseNote() is called.
+constexpr uint32_t DURATION_HELD = 0xFFFFFFFFu;
+
+// Called when a note shown with DURATION_HELD is released; its trail then fades out.
+void releaseNote(uint8_t note);
+
 // Optional: perform periodic update (call from main loop)
+// Trails advance in fixed simulation steps of elapsed time (MONALITH_SIM_STEP_US,
+// default 10 ms), so their speed does not depend on how often tick() runs.
+// A frame is rendered at most targetFps() times per second.
 void tick();
 
-// Display a persistent 64x64 bitmap (RGB565). See src/monalith.h for implementation.
+// Render rate cap in frames per second (default MONALITH_TARGET_FPS, 60).
+// 0 renders on every tick().
+void setTargetFps(uint16_t fps);
+uint16_t targetFps();
+uint32_t framePeriodUs();
+
+// Frame scheduler counters. A frame slot is missed when tick() was not called
+// before the next slot came up; maxLateUs is the worst lateness of a rendered
+// frame. simStepsDropped counts steps skipped after a stall too long to replay.
+struct SchedulerStats {
+	uint32_t frames;
+	uint32_t framesMissed;
+	uint32_t maxLateUs;
+	uint32_t simSteps;
+	uint32_t simStepsDropped;
+};
+SchedulerStats schedulerStats();
+void resetSchedulerStats();
+
+// Active notes live in a fixed pool of MONALITH_MAX_VOICES voices (default 32).
+// When it is full, a new note replaces the oldest (default) or quietest voice.
+void setVoiceStealPolicy(VoiceSteal policy);
+size_t activeVoiceCount();
+uint32_t stolenVoiceCount();
+
+// Display a persistent 64x64 bitmap (RGB565). Builds with MONALITH_BOOT_SELF_TEST=1
+// also start the panel self-test, which covers the bitmap until it finishes.
 void showStaticBitmap(const uint16_t* bitmap);
 void clearStaticBitmap();
-// Non-blocking variant: copy the provided bitmap and display immediately without
-// running the long diagnostic sequence. Safe for quick tests.
+// Copy the provided bitmap and present it immediately; never starts the self-test.
 void showStaticBitmapFast(const uint16_t* bitmap);
+// Decode a packed 64x64 overlay (src/overlay_asset.h) straight into the
+// background layer and show it like showStaticBitmap(). Returns false, and
+// leaves the background black, when the asset is malformed or not 64x64.
+bool showStaticOverlay(const OverlayAsset& overlay);
+
+// Panel wiring self-test: white hold, red/green/blue/white fills, then a row
+// sweep (about 35 s with the default MONALITH_SELF_TEST_*_MS timings). Returns
+// immediately; tick() advances it and notes are only drawn again once it ends.
+void startSelfTest();
+bool selfTestActive();
+
+// Clock time (ms since boot) at which the first frame showing a note since
+// init() was presented to the panel; 0 if none yet
+uint32_t firstNoteMs();
 
 // Display state machine and control helpers
 enum class DisplayState {
@@ -38,4 +89,32 @@ void visualizeDemoSafe(uint32_t ms);
 // Draw a 'C' glyph with a '#' symbol to its right across the panel for `ms` milliseconds
 void drawCSharp(uint32_t ms);
 
+// Label the newest sounding note with its name (e.g. "C#4") in the top-left
+// corner, drawn from the glyph atlas (glyph_atlas.h) on the annotation layer.
+void showNoteNames(bool on);
+
+// Presentation counters. A frame is skipped when tick() finds nothing changed
+// (or every redrawn row matches the panel); pixelsPushed counts pixels sent to
+// the driver, and pixelsPerSecond is that rate over the last full second.
+// panelRefreshes counts the backend refreshes tick() makes whether or not a
+// frame was presented (PxMatrix scans the panel in them).
+struct PresentStats {
+	uint32_t framesPresented;
+	uint32_t framesSkipped;
+	uint64_t pixelsPushed;
+	uint32_t pixelsPerSecond;
+	uint32_t panelRefreshes;
+};
+PresentStats presentStats();
+void resetPresentStats();
+
+// Name of the display backend compiled in with MONALITH_BACKEND (backend.h)
+const char* backendName();
+
+#if !defined(ARDUINO)
+// Host builds render into an in-memory 64x64 RGB565 framebuffer (row-major)
+// instead of a panel, so tests and benchmarks can inspect the output.
+const uint16_t* hostFramebuffer();
+#endif
+
 } // namespace Monalith
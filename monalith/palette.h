@@ -0,0 +1,107 @@
+#pragma once
+
+// palette.h - note colours for the Monalith visualizer as constexpr lookup
+// tables. Each pitch class owns a row of 256 brightness levels that is
+// converted from HSV, gamma corrected and packed to the canvas' RGB565 at
+// compile time. Colouring a pixel is then a single table read.
+
+#include <stdint.h>
+#include "../src/note_tables.h"
+#include "backend_select.h"
+
+// Display gamma folded into every table entry; 1.0 disables correction. The
+// I2S-DMA driver applies its own CIE 1931 lightness curve, so it gets none here.
+#ifndef MONALITH_GAMMA
+#if MONALITH_BACKEND == MONALITH_BACKEND_I2S_DMA
+#define MONALITH_GAMMA 1.0
+#else
+#define MONALITH_GAMMA 2.2
+#endif
+#endif
+
+namespace Monalith {
+namespace Palette {
+
+constexpr int ROWS = 12;       // one row per pitch class
+constexpr int LEVELS = 256;    // brightness 0..255
+constexpr uint8_t SATURATION = 200;
+
+struct Rgb { uint8_t r, g, b; };
+
+template <typename T>
+struct Rows {
+    T v[ROWS][LEVELS];
+    constexpr const T* operator[](uint8_t row) const { return v[row]; }
+};
+
+// Palette row for a MIDI note
+constexpr uint8_t row(uint8_t note) { return NoteTables::PITCH_CLASS[note]; }
+
+// ln(x) for 0 < x <= 1: reduce to [0.5, 1], then 2 * atanh((x - 1) / (x + 1))
+constexpr double logUnit(double x) {
+    int k = 0;
+    while (x < 0.5) { x *= 2; ++k; }
+    double z = (x - 1) / (x + 1), z2 = z * z, term = z, sum = 0;
+    for (int i = 1; i < 30; i += 2) { sum += term / i; term *= z2; }
+    return 2 * sum - k * 0.69314718055994531;
+}
+
+// exp(y) for y <= 0: Taylor series on y / 64, squared back up six times
+constexpr double expNeg(double y) {
+    double s = y / 64, term = 1, sum = 1;
+    for (int i = 1; i < 12; ++i) { term *= s / i; sum += term; }
+    for (int i = 0; i < 6; ++i) sum *= sum;
+    return sum;
+}
+
+struct GammaTable { uint8_t v[256]; };
+
+constexpr GammaTable makeGamma() {
+    GammaTable t{};
+    for (int i = 1; i < 256; ++i) t.v[i] = (uint8_t)(expNeg(MONALITH_GAMMA * logUnit(i / 255.0)) * 255.0 + 0.5);
+    return t;
+}
+
+inline constexpr GammaTable GAMMA = makeGamma();
+
+// Integer HSV -> RGB, the conversion Monalith used to run per pixel
+constexpr Rgb hsv(uint8_t H, uint8_t S, uint8_t V) {
+    uint8_t region = H / 43;
+    uint8_t remainder = (uint8_t)((H - (region * 43)) * 6);
+    uint8_t p = (uint8_t)((V * (255 - S)) >> 8);
+    uint8_t q = (uint8_t)((V * (255 - ((S * remainder) >> 8))) >> 8);
+    uint8_t t = (uint8_t)((V * (255 - ((S * (255 - remainder)) >> 8))) >> 8);
+    switch (region) {
+        case 0: return {V, t, p};
+        case 1: return {q, V, p};
+        case 2: return {p, V, t};
+        case 3: return {p, q, V};
+        case 4: return {t, p, V};
+        default: return {V, p, q};
+    }
+}
+
+constexpr Rgb corrected(Rgb c) { return {GAMMA.v[c.r], GAMMA.v[c.g], GAMMA.v[c.b]}; }
+
+constexpr uint16_t pack565(Rgb c) {
+    return (uint16_t)(((c.r & 0xF8) << 8) | ((c.g & 0xFC) << 3) | (c.b >> 3));
+}
+
+constexpr Rgb noteColour(int row, int level) {
+    return hsv(NoteTables::HUE[(uint8_t)row], SATURATION, (uint8_t)level);
+}
+
+constexpr Rows<uint16_t> makeRgb565() {
+    Rows<uint16_t> t{};
+    for (int r = 0; r < ROWS; ++r)
+        for (int l = 0; l < LEVELS; ++l) t.v[r][l] = pack565(corrected(noteColour(r, l)));
+    return t;
+}
+
+inline constexpr Rows<uint16_t> RGB565 = makeRgb565();
+
+static_assert(GAMMA.v[0] == 0 && GAMMA.v[255] == 255, "gamma endpoints");
+static_assert(RGB565.v[0][0] == 0, "level 0 is black");
+
+} // namespace Palette
+} // namespace Monalith
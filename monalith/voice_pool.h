@@ -0,0 +1,95 @@
+#pragma once
+
+// voice_pool.h - fixed-capacity pool of note voices for the Monalith visualizer.
+// Storage is structure-of-arrays so tick() streams through only the fields it
+// touches (trail level, expiry), and nothing is ever heap-allocated. Live voice
+// ids are kept densely packed in `active` for iteration; free ids sit on a
+// stack. Allocate and free are O(1). When every voice is busy, allocate()
+// steals one per the configured policy (a single O(Capacity) scan).
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace Monalith {
+
+enum class VoiceSteal : uint8_t {
+    Oldest,    // replace the voice that started first
+    Quietest,  // replace the voice with the lowest current brightness
+};
+
+template <size_t Capacity>
+class VoicePool {
+    static_assert(Capacity > 0 && Capacity <= 0xFFFF, "voice pool capacity out of range");
+
+public:
+    using Id = uint16_t;
+
+    // Per-voice fields, indexed by voice id
+    int16_t idx[Capacity];       // LED index of the note's main pixel
+    uint8_t colour[Capacity];    // palette row
+    uint8_t vel[Capacity];
+    uint8_t note[Capacity];
+    uint8_t level[Capacity];     // current trail brightness
+    bool held[Capacity];         // lit until released
+    uint32_t start_ms[Capacity];
+    uint32_t expire_ms[Capacity];
+
+    VoicePool() { clear(); }
+
+    void clear() {
+        activeCount_ = 0;
+        freeCount_ = Capacity;
+        for (size_t i = 0; i < Capacity; ++i) freeIds_[i] = (Id)(Capacity - 1 - i);
+    }
+
+    // Grab a voice; steals one if the pool is full. The caller fills in the fields.
+    Id allocate() {
+        if (freeCount_ == 0) {
+            ++stolen_;
+            release(victim());
+        }
+        Id id = freeIds_[--freeCount_];
+        pos_[id] = (Id)activeCount_;
+        active_[activeCount_++] = id;
+        return id;
+    }
+
+    // Return a live voice to the pool. Swaps the last live voice into its slot,
+    // so when freeing while iterating, walk the live list backwards.
+    void release(Id id) {
+        Id p = pos_[id];
+        Id last = active_[--activeCount_];
+        active_[p] = last;
+        pos_[last] = p;
+        freeIds_[freeCount_++] = id;
+    }
+
+    size_t size() const { return activeCount_; }
+    static constexpr size_t capacity() { return Capacity; }
+    // Live voice id at position i (0 <= i < size())
+    Id at(size_t i) const { return active_[i]; }
+
+    void setPolicy(VoiceSteal p) { policy_ = p; }
+    VoiceSteal policy() const { return policy_; }
+    uint32_t stolen() const { return stolen_; }
+
+private:
+    Id victim() const {
+        Id best = active_[0];
+        for (size_t i = 1; i < activeCount_; ++i) {
+            Id v = active_[i];
+            if (policy_ == VoiceSteal::Oldest ? (int32_t)(start_ms[v] - start_ms[best]) < 0 : level[v] < level[best]) best = v;
+        }
+        return best;
+    }
+
+    Id active_[Capacity];
+    Id pos_[Capacity];
+    Id freeIds_[Capacity];
+    size_t activeCount_ = 0;
+    size_t freeCount_ = Capacity;
+    VoiceSteal policy_ = VoiceSteal::Oldest;
+    uint32_t stolen_ = 0;
+};
+
+} // namespace Monalith
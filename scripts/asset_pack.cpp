@@ -0,0 +1,74 @@
+// asset_pack - build the overlay bundle (src/asset_bundle.h) for the assets
+// partition from 24-bit BMPs. Each overlay is stored in its smallest format
+// (see overlay_pack); write the result with scripts/upload_assets.sh.
+//
+//   g++ -std=c++17 -O2 -o scripts/asset_pack scripts/asset_pack.cpp
+//   scripts/asset_pack -o assets.bin boot="TeachTiles Graphical Overlay v1.bmp" staff=midi_note_display/teachtiles_overlay.bmp:invert
+//
+// Arguments are NAME=FILE.bmp[:invert]; names are up to 11 characters. The
+// firmware shows the overlay named "boot" at power-on when the bundle has one.
+//
+// Options:
+//   -o FILE           output file (default: assets.bin)
+//   --max-bytes N     fail if the bundle is larger (default: 0x40000, the
+//                     assets partition in partitions.csv)
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "stb_image.h"
+#include "bundle_encode.h"
+
+int main(int argc, char** argv) {
+    std::string outPath = "assets.bin";
+    unsigned long maxBytes = 0x40000;
+    std::vector<NamedOverlay> items;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "-o") && i + 1 < argc) { outPath = argv[++i]; continue; }
+        if (!std::strcmp(argv[i], "--max-bytes") && i + 1 < argc) { maxBytes = std::strtoul(argv[++i], nullptr, 0); continue; }
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (eq == std::string::npos) {
+            std::fprintf(stderr, "usage: %s [-o file] [--max-bytes n] name=file.bmp[:invert] ...\n", argv[0]);
+            return 1;
+        }
+        std::string name = arg.substr(0, eq), path = arg.substr(eq + 1);
+        bool invert = false;
+        if (path.size() > 7 && path.compare(path.size() - 7, 7, ":invert") == 0) {
+            invert = true;
+            path.resize(path.size() - 7);
+        }
+        int w = 0, h = 0;
+        std::vector<uint8_t> rgb;
+        if (!load_bmp(path.c_str(), w, h, rgb)) {
+            std::fprintf(stderr, "Failed to load %s\n", path.c_str());
+            return 2;
+        }
+        std::vector<uint16_t> px = rgb888ToRgb565(rgb, invert);
+        NamedOverlay item{name, encodeSmallestOverlay(px.data(), w, h)};
+        std::fprintf(stderr, "  %-11s %dx%d %-6s %6zu bytes  (%s%s)\n", name.c_str(), w, h,
+                     overlayFormatName(item.overlay.format), item.overlay.bytes(), path.c_str(), invert ? ", inverted" : "");
+        items.push_back(item);
+    }
+    if (items.empty()) {
+        std::fprintf(stderr, "no overlays given\n");
+        return 1;
+    }
+
+    std::vector<uint8_t> bundle = buildAssetBundle(items);
+    if (bundle.empty()) {
+        std::fprintf(stderr, "overlay names must be unique and 1-%zu characters\n", AssetBundle::NAME_LEN - 1);
+        return 3;
+    }
+    if (bundle.size() > maxBytes) {
+        std::fprintf(stderr, "bundle is %zu bytes, partition holds %lu\n", bundle.size(), maxBytes);
+        return 3;
+    }
+    std::ofstream f(outPath, std::ios::binary | std::ios::trunc);
+    if (!f) { std::fprintf(stderr, "Failed to open %s for writing\n", outPath.c_str()); return 4; }
+    f.write((const char*)bundle.data(), (std::streamsize)bundle.size());
+    std::fprintf(stderr, "wrote %s: %zu overlay(s), %zu bytes\n", outPath.c_str(), items.size(), bundle.size());
+    return 0;
+}
@@ -0,0 +1,50 @@
+// bundle_encode.h - host-side writer for src/asset_bundle.h: lays out encoded
+// overlays (scripts/overlay_encode.h) as the bundle image that
+// scripts/upload_assets.sh writes to the assets partition.
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "overlay_encode.h"
+#include "../src/asset_bundle.h"
+
+struct NamedOverlay {
+    std::string name;
+    EncodedOverlay overlay;
+};
+
+// The bundle image, or an empty vector when a name is empty, too long for
+// AssetBundle::NAME_LEN or used twice
+inline std::vector<uint8_t> buildAssetBundle(const std::vector<NamedOverlay>& items) {
+    using namespace AssetBundle;
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (items[i].name.empty() || items[i].name.size() >= NAME_LEN) return {};
+        for (size_t j = 0; j < i; ++j) if (items[j].name == items[i].name) return {};
+    }
+    std::vector<uint8_t> out(sizeof(Header) + items.size() * sizeof(Entry), 0);
+    auto append = [&](const void* p, size_t n) {
+        while (out.size() % 4) out.push_back(0);
+        uint32_t at = (uint32_t)out.size();
+        out.insert(out.end(), (const uint8_t*)p, (const uint8_t*)p + n);
+        return at;
+    };
+    for (size_t i = 0; i < items.size(); ++i) {
+        const EncodedOverlay& o = items[i].overlay;
+        Entry e{};
+        memcpy(e.name, items[i].name.data(), items[i].name.size());
+        e.format = (uint8_t)o.format;
+        e.paletteSize = (uint8_t)o.palette.size();
+        e.width = (uint16_t)o.width;
+        e.height = (uint16_t)o.height;
+        e.paletteOffset = o.palette.empty() ? 0 : append(o.palette.data(), o.palette.size() * sizeof(uint16_t));
+        e.dataOffset = append(o.data.data(), o.data.size());
+        e.dataBytes = (uint32_t)o.data.size();
+        memcpy(out.data() + sizeof(Header) + i * sizeof(Entry), &e, sizeof(e));
+    }
+    Header h{MAGIC, VERSION, (uint16_t)items.size(), (uint32_t)out.size(), 0};
+    h.crc = crc32(out.data() + sizeof(Header), out.size() - sizeof(Header));
+    memcpy(out.data(), &h, sizeof(h));
+    return out;
+}
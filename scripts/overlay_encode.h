@@ -0,0 +1,149 @@
+// overlay_encode.h - host-side encoder for src/overlay_asset.h: builds the
+// palette of an RGB565 image, packs it in one of the overlay formats, picks
+// the smallest format that fits, and writes the result as C source.
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../src/overlay_asset.h"
+
+struct EncodedOverlay {
+    int format = OVERLAY_RGB565;
+    int width = 0;
+    int height = 0;
+    std::vector<uint16_t> palette;
+    std::vector<uint8_t> data;
+
+    size_t bytes() const { return data.size() + palette.size() * sizeof(uint16_t); }
+    OverlayAsset asset() const {
+        return OverlayAsset{(uint8_t)format, (uint8_t)palette.size(), (uint16_t)width, (uint16_t)height,
+                            palette.empty() ? nullptr : palette.data(), data.data(), (uint32_t)data.size()};
+    }
+};
+
+inline const char* overlayFormatName(int format) {
+    switch (format) {
+        case OVERLAY_RGB565: return "rgb565";
+        case OVERLAY_MASK1: return "mask1";
+        case OVERLAY_PAL2: return "pal2";
+        case OVERLAY_PAL4: return "pal4";
+        case OVERLAY_RLE: return "rle";
+        default: return "?";
+    }
+}
+
+// Packed 8-bit RGB triplets (as load_bmp returns them) to RGB565, inverting
+// first when asked (white paper -> black panel)
+inline std::vector<uint16_t> rgb888ToRgb565(const std::vector<uint8_t>& rgb, bool invert) {
+    std::vector<uint16_t> px(rgb.size() / 3);
+    for (size_t i = 0; i < px.size(); ++i) {
+        uint8_t r = rgb[i * 3], g = rgb[i * 3 + 1], b = rgb[i * 3 + 2];
+        if (invert) { r = 255 - r; g = 255 - g; b = 255 - b; }
+        px[i] = (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+    }
+    return px;
+}
+
+// Colours in order of first appearance
+inline std::vector<uint16_t> overlayPalette(const uint16_t* px, int w, int h) {
+    std::vector<uint16_t> pal;
+    for (int i = 0; i < w * h; ++i) {
+        bool found = false;
+        for (uint16_t c : pal) if (c == px[i]) { found = true; break; }
+        if (!found) pal.push_back(px[i]);
+    }
+    return pal;
+}
+
+// Encode `px` (w x h RGB565, row-major) as `format`. Returns false when the
+// image has more colours than the format can index.
+inline bool encodeOverlay(const uint16_t* px, int w, int h, int format, EncodedOverlay& out) {
+    out = EncodedOverlay{};
+    out.format = format;
+    out.width = w;
+    out.height = h;
+    if (format == OVERLAY_RGB565) {
+        out.data.resize((size_t)w * h * 2);
+        for (int i = 0; i < w * h; ++i) {
+            out.data[i * 2] = (uint8_t)(px[i] & 0xFF);
+            out.data[i * 2 + 1] = (uint8_t)(px[i] >> 8);
+        }
+        return true;
+    }
+    out.palette = overlayPalette(px, w, h);
+    auto index = [&](uint16_t c) {
+        for (size_t k = 0; k < out.palette.size(); ++k) if (out.palette[k] == c) return (uint8_t)k;
+        return (uint8_t)0;
+    };
+    if (format == OVERLAY_RLE) {
+        if (out.palette.size() > 16) return false;
+        for (int i = 0; i < w * h;) {
+            uint8_t idx = index(px[i]);
+            int run = 1;
+            while (i + run < w * h && run < Overlay::RLE_MAX_RUN && px[i + run] == px[i]) ++run;
+            if (run < Overlay::RLE_LONG_MIN) {
+                out.data.push_back((uint8_t)(((run - 1) << 4) | idx));
+            } else {
+                out.data.push_back((uint8_t)((Overlay::RLE_EXTENDED << 4) | idx));
+                out.data.push_back((uint8_t)(run - Overlay::RLE_LONG_MIN));
+            }
+            i += run;
+        }
+        return true;
+    }
+    const int bpp = Overlay::bitsPerPixel((uint8_t)format);
+    if (bpp == 0 || out.palette.size() > (size_t)(1 << bpp)) return false;
+    const size_t rowBytes = Overlay::packedRowBytes((uint8_t)format, w);
+    out.data.assign(rowBytes * h, 0);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            int bit = x * bpp;
+            out.data[rowBytes * y + bit / 8] |= (uint8_t)(index(px[y * w + x]) << (8 - bpp - bit % 8));
+        }
+    }
+    return true;
+}
+
+// The smallest encoding of the image over every format it fits
+inline EncodedOverlay encodeSmallestOverlay(const uint16_t* px, int w, int h) {
+    EncodedOverlay best;
+    encodeOverlay(px, w, h, OVERLAY_RGB565, best);
+    for (int f : {OVERLAY_MASK1, OVERLAY_PAL2, OVERLAY_PAL4, OVERLAY_RLE}) {
+        EncodedOverlay e;
+        if (encodeOverlay(px, w, h, f, e) && e.bytes() < best.bytes()) best = e;
+    }
+    return best;
+}
+
+// C source defining `const OverlayAsset <name>` (plus its palette and data
+// arrays), compilable as C or C++
+inline std::string overlayToC(const EncodedOverlay& e, const std::string& name) {
+    std::string s;
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), "// %dx%d overlay, %s, %zu bytes (generated by scripts/overlay_pack)\n",
+                  e.width, e.height, overlayFormatName(e.format), e.bytes());
+    s += buf;
+    if (!e.palette.empty()) {
+        s += "static const uint16_t " + name + "_palette[" + std::to_string(e.palette.size()) + "] = {";
+        for (size_t i = 0; i < e.palette.size(); ++i) {
+            std::snprintf(buf, sizeof(buf), "%s0x%04X", i ? ", " : "", e.palette[i]);
+            s += buf;
+        }
+        s += "};\n";
+    }
+    s += "static const uint8_t " + name + "_data[" + std::to_string(e.data.size()) + "] = {\n";
+    for (size_t i = 0; i < e.data.size(); ++i) {
+        std::snprintf(buf, sizeof(buf), "%s0x%02X,", (i % 16) ? " " : "    ", e.data[i]);
+        s += buf;
+        if (i % 16 == 15 || i + 1 == e.data.size()) s += "\n";
+    }
+    s += "};\n";
+    s += "extern const OverlayAsset " + name + ";\n";
+    std::snprintf(buf, sizeof(buf), "const OverlayAsset %s = {%d, %zu, %d, %d, ", name.c_str(), e.format, e.palette.size(), e.width, e.height);
+    s += buf;
+    s += e.palette.empty() ? "0" : name + "_palette";
+    s += ", " + name + "_data, " + std::to_string(e.data.size()) + "};\n";
+    return s;
+}
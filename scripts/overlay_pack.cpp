@@ -0,0 +1,80 @@
+// overlay_pack - convert a 24-bit BMP into a compact overlay asset (see
+// src/overlay_asset.h). Prints the size every format would take and writes
+// the smallest (or the one given with --format) as C source.
+//
+//   g++ -std=c++17 -O2 -o scripts/overlay_pack scripts/overlay_pack.cpp
+//   scripts/overlay_pack "TeachTiles Graphical Overlay v1.bmp" example_overlay -o example_bitmap.c
+//
+// Options:
+//   -o FILE           output file (default: stdout)
+//   --format NAME     rgb565, mask1, pal2, pal4 or rle (default: smallest)
+//   --invert          invert colours first (white paper -> black panel)
+//   --include PATH    how the output includes overlay_asset.h (default: src/overlay_asset.h)
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "stb_image.h"
+#include "overlay_encode.h"
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s input.bmp name [-o file] [--format f] [--invert] [--include path]\n", argv[0]);
+        return 1;
+    }
+    const char* in = argv[1];
+    std::string name = argv[2];
+    std::string outPath, include = "src/overlay_asset.h";
+    int format = -1;
+    bool invert = false;
+    for (int i = 3; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "-o") && i + 1 < argc) outPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--include") && i + 1 < argc) include = argv[++i];
+        else if (!std::strcmp(argv[i], "--invert")) invert = true;
+        else if (!std::strcmp(argv[i], "--format") && i + 1 < argc) {
+            const char* f = argv[++i];
+            for (int k = OVERLAY_RGB565; k <= OVERLAY_RLE; ++k)
+                if (!std::strcmp(f, overlayFormatName(k))) format = k;
+            if (format < 0) { std::fprintf(stderr, "unknown format %s\n", f); return 1; }
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    int w = 0, h = 0;
+    std::vector<uint8_t> rgb;
+    if (!load_bmp(in, w, h, rgb)) {
+        std::fprintf(stderr, "Failed to load %s\n", in);
+        return 2;
+    }
+    std::vector<uint16_t> px = rgb888ToRgb565(rgb, invert);
+
+    std::fprintf(stderr, "%s: %dx%d, %zu colour(s)\n", in, w, h, overlayPalette(px.data(), w, h).size());
+    for (int f = OVERLAY_RGB565; f <= OVERLAY_RLE; ++f) {
+        EncodedOverlay e;
+        if (encodeOverlay(px.data(), w, h, f, e)) std::fprintf(stderr, "  %-7s %6zu bytes\n", overlayFormatName(f), e.bytes());
+        else std::fprintf(stderr, "  %-7s   (too many colours)\n", overlayFormatName(f));
+    }
+    EncodedOverlay e;
+    if (format < 0) {
+        e = encodeSmallestOverlay(px.data(), w, h);
+    } else if (!encodeOverlay(px.data(), w, h, format, e)) {
+        std::fprintf(stderr, "%s does not fit in %s\n", in, overlayFormatName(format));
+        return 3;
+    }
+    std::fprintf(stderr, "writing %s (%zu bytes)\n", overlayFormatName(e.format), e.bytes());
+
+    std::string src = "#include \"" + include + "\"\n\n" + overlayToC(e, name);
+    if (outPath.size() > 2 && outPath.compare(outPath.size() - 2, 2, ".h") == 0) src = "#pragma once\n\n" + src;
+    if (outPath.empty()) {
+        std::fputs(src.c_str(), stdout);
+        return 0;
+    }
+    std::ofstream f(outPath, std::ios::trunc);
+    if (!f) { std::fprintf(stderr, "Failed to open %s for writing\n", outPath.c_str()); return 4; }
+    f << src;
+    return 0;
+}
@@ -0,0 +1,25 @@
+#!/usr/bin/env bash
+set -euo pipefail
+# Copy the shared headers the midi_note_display sketch uses from src/ into
+# midi_note_display/src/. arduino-cli builds a sketch from a copy of its own
+# folder (plus src/ inside it), so "../src/..." includes do not resolve there.
+# Run after editing any of these headers; --check only reports stale copies
+# (tests/run_tests.sh runs it that way).
+#   scripts/sync_sketch_headers.sh [--check]
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+DEST="$ROOT/midi_note_display/src"
+HEADERS=(note_tables.h staff_renderer.h spsc_queue.h latency_stats.h overlay_asset.h)
+
+stale=0
+mkdir -p "$DEST"
+for h in "${HEADERS[@]}"; do
+  if cmp -s "$ROOT/src/$h" "$DEST/$h"; then continue; fi
+  if [ "${1:-}" = "--check" ]; then
+    echo "midi_note_display/src/$h is out of date; run scripts/sync_sketch_headers.sh"
+    stale=1
+  else
+    cp "$ROOT/src/$h" "$DEST/$h"
+    echo "Updated midi_note_display/src/$h"
+  fi
+done
+exit $stale
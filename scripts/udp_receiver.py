@@ -1,9 +1,13 @@
 #!/usr/bin/env python3
 """
-Simple UDP receiver to accept 5-byte MIDI packets from the ESP32's UDP transport.
-Packet format: [note(1), duration(4 bytes big-endian)]
+Simple UDP receiver to accept MIDI packets from the ESP32's UDP transport.
+v2 frames:       [0xF5, 2, flags, count, seq(2), time_ms(4)] + count x
+                 [type, note, velocity, source, dt_ms(2), duration_ms(4)]  (see src/wire_protocol.h)
+v1 events:       [status(1: 0x90 on / 0x80 off), note(1), velocity(1)]
+Legacy packets:  [note(1), duration(4 bytes big-endian)]
 """
 import socket
+import struct
 
 HOST = '0.0.0.0'
 PORT = 5005
@@ -17,8 +21,29 @@ note_names = ["C","C#","D","D#","E","F","F#","G","G#","A","A#","B"]
 def note_name(n):
     return f"{note_names[n%12]}{n//12 - 1}"
 
+EVENT_TYPES = {1: "ON", 2: "OFF", 3: "DURATION"}
+last_seq = None
+
 while True:
     data, addr = sock.recvfrom(1024)
+    if len(data) >= 10 and data[0] == 0xF5 and data[1] == 2:
+        _, _, flags, count, seq, t0 = struct.unpack(">BBBBHI", data[:10])
+        if last_seq is not None and seq != (last_seq + 1) & 0xFFFF:
+            print(f"  (seq jump {last_seq} -> {seq})")
+        last_seq = seq
+        print(f"From {addr}: frame seq={seq} t={t0} ms events={count}")
+        for i in range(count):
+            off = 10 + i * 10
+            if off + 10 > len(data):
+                print("  truncated frame")
+                break
+            etype, note, vel, src, dt, dur = struct.unpack(">BBBBHI", data[off:off + 10])
+            print(f"  +{dt} ms {EVENT_TYPES.get(etype, etype)} {note_name(note)} ({note}) vel={vel} src={src} dur={dur}")
+        continue
+    if len(data) >= 3 and data[0] & 0x80:
+        state = "ON" if (data[0] & 0xF0) == 0x90 and data[2] > 0 else "OFF"
+        print(f"From {addr}: Note {note_name(data[1])} ({data[1]}) velocity={data[2]} {state}")
+        continue
     if len(data) < 5:
         print("Short packet", data)
         continue
@@ -0,0 +1,58 @@
+#!/usr/bin/env bash
+set -euo pipefail
+# Write an overlay bundle (built by scripts/asset_pack) to the assets partition
+# over USB. Only the partition is written, not the app, so this takes a few
+# seconds; the board resets afterwards and shows the new overlays.
+#   scripts/upload_assets.sh [assets.bin] [port]
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+BUNDLE="${1:-assets.bin}"
+PORT="${2:-}"
+
+if [ ! -f "$BUNDLE" ]; then
+  echo "Bundle $BUNDLE not found. Build it with scripts/asset_pack."
+  exit 1
+fi
+
+# Offset and size of the assets partition, from the table the firmware was built with
+read -r OFFSET SIZE < <(awk -F, '$1 ~ /^assets/ { gsub(/ /, ""); print $4, $5 }' "$ROOT/partitions.csv")
+if [ -z "${OFFSET:-}" ]; then
+  echo "No assets partition in $ROOT/partitions.csv"
+  exit 1
+fi
+BYTES=$(wc -c < "$BUNDLE" | tr -d ' ')
+if [ "$BYTES" -gt $((SIZE)) ]; then
+  echo "$BUNDLE is $BYTES bytes; the assets partition holds $((SIZE))"
+  exit 1
+fi
+
+# esptool from PATH, else the copy installed with the Arduino ESP32 core
+ESPTOOL=$(command -v esptool.py || command -v esptool || true)
+if [ -z "$ESPTOOL" ]; then
+  for c in "$HOME"/Library/Arduino15/packages/esp32/tools/esptool_py/*/esptool "$HOME"/.arduino15/packages/esp32/tools/esptool_py/*/esptool "$HOME"/.arduino15/packages/esp32/tools/esptool_py/*/esptool.py; do
+    if [ -x "$c" ]; then ESPTOOL="$c"; fi
+  done
+fi
+if [ -z "$ESPTOOL" ]; then
+  echo "esptool not found. Install it (pip install esptool) or the Arduino ESP32 core."
+  exit 1
+fi
+
+if [ -z "$PORT" ]; then
+  candidates=(/dev/cu.SLAB_USBtoUART /dev/cu.usbserial* /dev/cu.usbmodem* /dev/cu.wchusbserial* /dev/ttyUSB* /dev/ttyACM*)
+  for c in "${candidates[@]}"; do
+    for match in $c; do
+      if [ -e "$match" ]; then
+        PORT="$match"
+        break 2
+      fi
+    done
+  done
+fi
+if [ -z "$PORT" ]; then
+  echo "No serial port specified or detected. Pass it as the second arg."
+  exit 2
+fi
+
+echo "Writing $BUNDLE ($BYTES bytes) to the assets partition at $OFFSET on $PORT"
+"$ESPTOOL" --chip esp32 --port "$PORT" --baud 921600 write_flash "$OFFSET" "$BUNDLE"
+echo "Done. The board has been reset and loads the new bundle at boot."
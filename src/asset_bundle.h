@@ -0,0 +1,157 @@
+#pragma once
+
+// asset_bundle.h - an indexed bundle of overlay assets (src/overlay_asset.h)
+// kept in its own flash partition, so lesson backgrounds change without
+// rebuilding the firmware. The bundle is read in place: View::find() returns
+// OverlayAssets whose palette and data point into the bundle itself, and on
+// the ESP32 that is the memory-mapped partition (src/asset_partition.h), so
+// Overlay::decode() blits from flash with no copy in RAM.
+//
+// Layout, little-endian, built by scripts/asset_pack:
+//
+//   Header   magic "TTAB", version, entry count, total bytes, CRC-32 of
+//            everything after the header
+//   Entry[]  name, format, palette size, width, height, and offsets of the
+//            palette and pixel data from the start of the bundle
+//   payload  palettes and pixel data, each 4-byte aligned
+//
+// Erased flash (0xFF) fails the magic check, so an empty partition simply
+// reads as "no bundle" and the firmware falls back to its built-in overlays.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "overlay_asset.h"
+
+namespace AssetBundle {
+
+constexpr uint32_t MAGIC = 0x42415454;   // "TTAB"
+constexpr uint16_t VERSION = 1;
+constexpr size_t NAME_LEN = 12;          // including the terminating NUL
+
+struct Header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t totalBytes;   // header, entries and payload
+    uint32_t crc;          // CRC-32 of bytes [sizeof(Header), totalBytes)
+};
+
+struct Entry {
+    char name[NAME_LEN];
+    uint8_t format;        // OverlayFormat
+    uint8_t paletteSize;
+    uint16_t width;
+    uint16_t height;
+    uint16_t reserved;
+    uint32_t paletteOffset;
+    uint32_t dataOffset;
+    uint32_t dataBytes;
+};
+
+static_assert(sizeof(Header) == 16 && sizeof(Entry) == 32, "bundle layout is fixed");
+
+enum Status : uint8_t { OK, NO_BUNDLE, BAD_VERSION, TRUNCATED, BAD_CRC, BAD_ENTRY };
+
+inline const char* statusName(Status s) {
+    switch (s) {
+        case OK: return "ok";
+        case NO_BUNDLE: return "no bundle";
+        case BAD_VERSION: return "unsupported version";
+        case TRUNCATED: return "truncated";
+        case BAD_CRC: return "CRC mismatch";
+        case BAD_ENTRY: return "bad entry";
+        default: return "?";
+    }
+}
+
+// Standard CRC-32 (zlib, poly 0xEDB88320); chain calls by passing the previous result
+inline uint32_t crc32(const uint8_t* p, size_t n, uint32_t crc = 0) {
+    crc = ~crc;
+    while (n--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; ++k) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
+
+class View {
+public:
+    // Check the bundle at base (size bytes available) and keep a view of it.
+    // Nothing is copied, so base must stay valid while the view is used.
+    Status open(const uint8_t* base, size_t size) {
+        base_ = nullptr;
+        count_ = 0;
+        Header h;
+        if (!base || size < sizeof(Header)) return status_ = NO_BUNDLE;
+        memcpy(&h, base, sizeof(h));
+        if (h.magic != MAGIC) return status_ = NO_BUNDLE;
+        if (h.version != VERSION) return status_ = BAD_VERSION;
+        if (h.totalBytes > size || h.totalBytes < sizeof(Header) + (size_t)h.count * sizeof(Entry)) return status_ = TRUNCATED;
+        if (crc32(base + sizeof(Header), h.totalBytes - sizeof(Header)) != h.crc) return status_ = BAD_CRC;
+        for (uint16_t i = 0; i < h.count; ++i) {
+            Entry e = entry(base, i);
+            if (!entryFits(e, h.totalBytes)) return status_ = BAD_ENTRY;
+        }
+        base_ = base;
+        count_ = h.count;
+        bytes_ = h.totalBytes;
+        return status_ = OK;
+    }
+
+    Status status() const { return status_; }
+    bool valid() const { return status_ == OK; }
+    uint16_t count() const { return count_; }
+    uint32_t bytes() const { return valid() ? bytes_ : 0; }
+
+    // Entry i's name (always NUL-terminated) and asset, pointing into the bundle
+    bool at(uint16_t i, OverlayAsset& out, char* name = nullptr) const {
+        if (!valid() || i >= count_) return false;
+        Entry e = entry(base_, i);
+        if (name) {
+            memcpy(name, e.name, NAME_LEN);
+            name[NAME_LEN - 1] = '\0';
+        }
+        out.format = e.format;
+        out.paletteSize = e.paletteSize;
+        out.width = e.width;
+        out.height = e.height;
+        out.palette = e.paletteSize ? reinterpret_cast<const uint16_t*>(base_ + e.paletteOffset) : nullptr;
+        out.data = base_ + e.dataOffset;
+        out.dataBytes = e.dataBytes;
+        return true;
+    }
+
+    bool find(const char* name, OverlayAsset& out) const {
+        char n[NAME_LEN];
+        for (uint16_t i = 0; i < count_; ++i) {
+            if (at(i, out, n) && strncmp(n, name, NAME_LEN) == 0) return true;
+        }
+        return false;
+    }
+
+private:
+    static Entry entry(const uint8_t* base, uint16_t i) {
+        Entry e;
+        memcpy(&e, base + sizeof(Header) + (size_t)i * sizeof(Entry), sizeof(e));
+        return e;
+    }
+
+    // The entry's palette and data lie inside the bundle; the palette is
+    // 2-byte aligned so it can be read as uint16_t in place
+    static bool entryFits(const Entry& e, uint32_t total) {
+        if (memchr(e.name, '\0', NAME_LEN) == nullptr) return false;
+        if (e.format > OVERLAY_RLE || e.width == 0 || e.height == 0) return false;
+        if (e.paletteSize) {
+            if (e.paletteOffset % 2 || e.paletteOffset > total || total - e.paletteOffset < e.paletteSize * 2u) return false;
+        }
+        return e.dataOffset <= total && total - e.dataOffset >= e.dataBytes;
+    }
+
+    const uint8_t* base_ = nullptr;
+    uint16_t count_ = 0;
+    uint32_t bytes_ = 0;
+    Status status_ = NO_BUNDLE;
+};
+
+} // namespace AssetBundle
@@ -0,0 +1,43 @@
+#pragma once
+
+// asset_partition.h - the "assets" data partition from partitions.csv,
+// memory-mapped once at boot and opened as an AssetBundle::View. The mapping
+// is never released, so OverlayAssets found in the bundle can be decoded
+// straight from flash at any time. scripts/upload_assets.sh rewrites the
+// partition over USB without touching the app.
+
+#include <stdint.h>
+#include "asset_bundle.h"
+
+#if defined(ESP32)
+#include <esp_partition.h>
+#include <esp_idf_version.h>
+#endif
+
+namespace AssetPartition {
+
+// Must match the assets line in partitions.csv
+constexpr const char* LABEL = "assets";
+constexpr uint8_t SUBTYPE = 0x40;
+
+// Map the partition and open the bundle in it. Returns the view's status;
+// NO_BUNDLE as well when the partition is missing (older partition table,
+// host build) or cannot be mapped.
+inline AssetBundle::Status mount(AssetBundle::View& view) {
+#if defined(ESP32)
+    const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)SUBTYPE, LABEL);
+    if (!part) return view.open(nullptr, 0);
+    const void* mapped = nullptr;
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_partition_mmap_handle_t handle;
+#else
+    spi_flash_mmap_handle_t handle;
+#endif
+    if (esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &mapped, &handle) != ESP_OK) return view.open(nullptr, 0);
+    return view.open(static_cast<const uint8_t*>(mapped), part->size);
+#else
+    return view.open(nullptr, 0);
+#endif
+}
+
+} // namespace AssetPartition
@@ -0,0 +1,35 @@
+#pragma once
+
+// clock.h - time source read by firmware code (main.cpp, Monalith).
+// By default it reads the platform clock: esp_timer_get_time() on ESP32,
+// std::chrono::steady_clock on host. Host tests can switch to a virtual clock
+// and advance it by hand, so simulated sessions run as fast as the CPU allows
+// and durations are exact.
+
+#include <stdint.h>
+#include <atomic>
+
+namespace Clock {
+
+// Platform microsecond clock; defined in main.cpp.
+uint64_t platformMicros();
+
+inline std::atomic<bool> virtualMode{false};
+inline std::atomic<uint64_t> virtualUs{0};
+
+inline uint64_t nowUs() {
+    return virtualMode.load(std::memory_order_relaxed) ? virtualUs.load(std::memory_order_relaxed) : platformMicros();
+}
+inline uint32_t nowMs() { return (uint32_t)(nowUs() / 1000); }
+
+// Switch to the virtual clock, starting at `startUs`. Time then only moves
+// when advanceUs()/advanceMs() is called.
+inline void useVirtual(uint64_t startUs = 0) {
+    virtualUs.store(startUs);
+    virtualMode.store(true);
+}
+inline void useReal() { virtualMode.store(false); }
+inline void advanceUs(uint64_t us) { virtualUs.fetch_add(us); }
+inline void advanceMs(uint64_t ms) { advanceUs(ms * 1000); }
+
+} // namespace Clock
@@ -14,6 +14,6 @@ struct HostSerial2 {
 struct HostBT {
     bool begin(const char* name);
     size_t write(const uint8_t* buf, size_t n);
-    const std::vector<std::array<uint8_t,5>>& getCaptured() const;
+    const std::vector<std::vector<uint8_t>>& getCaptured() const;
     void clear();
 };
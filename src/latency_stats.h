@@ -0,0 +1,71 @@
+#pragma once
+
+// latency_stats.h - input-to-pixel latency histogram for midi_note_display.
+// Each sample runs from the arrival of a note's last MIDI byte (stamped in
+// the UART receive callback) to the moment its sprite has been written to
+// the panel's DMA buffer. Samples go into fixed 50 us buckets, so add() is
+// constant time and allocation-free; take() turns a window of them into
+// p50/p99/max once enough time has passed.
+
+#include <stdint.h>
+
+struct LatencyStats {
+    static constexpr uint32_t BUCKET_US = 50;
+    static constexpr int BUCKETS = 200;   // the last bucket also holds everything >= 10 ms
+
+    struct Report {
+        uint32_t count;
+        uint32_t p50Us;   // upper edge of the bucket holding the percentile (at most maxUs)
+        uint32_t p99Us;
+        uint32_t maxUs;
+    };
+
+    void add(uint32_t us) {
+        int b = (int)(us / BUCKET_US);
+        ++buckets_[b < BUCKETS ? b : BUCKETS - 1];
+        ++count_;
+        if (us > maxUs_) maxUs_ = us;
+    }
+
+    uint32_t count() const { return count_; }
+
+    // Fill out and start a new window once windowUs has passed since the
+    // last one and it holds at least one sample. The first call only starts
+    // the window.
+    bool take(uint64_t nowUs, uint64_t windowUs, Report& out) {
+        if (!started_) {
+            started_ = true;
+            windowStartUs_ = nowUs;
+            return false;
+        }
+        if (nowUs - windowStartUs_ < windowUs || count_ == 0) return false;
+        out.count = count_;
+        out.p50Us = percentile(50);
+        out.p99Us = percentile(99);
+        out.maxUs = maxUs_;
+        windowStartUs_ = nowUs;
+        for (uint32_t& b : buckets_) b = 0;
+        count_ = maxUs_ = 0;
+        return true;
+    }
+
+private:
+    uint32_t percentile(uint32_t pct) const {
+        // smallest bucket with at least pct% of the samples at or below it
+        uint64_t need = ((uint64_t)count_ * pct + 99) / 100;
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; ++b) {
+            seen += buckets_[b];
+            if (seen < need) continue;
+            uint32_t edge = (uint32_t)(b + 1) * BUCKET_US;
+            return b == BUCKETS - 1 || edge > maxUs_ ? maxUs_ : edge;
+        }
+        return maxUs_;
+    }
+
+    bool started_ = false;
+    uint64_t windowStartUs_ = 0;
+    uint32_t buckets_[BUCKETS] = {};
+    uint32_t count_ = 0;
+    uint32_t maxUs_ = 0;
+};
@@ -0,0 +1,255 @@
+#pragma once
+
+// log_ring.h - deferred binary logging for the firmware hot paths.
+// Log calls store a compact record (format id, up to six integer args and
+// an optional static string) in a lock-free ring; the text is only produced
+// when the ring is flushed, from a low-priority task on ESP32 or at the end
+// of loop() on host. Serial output therefore never blocks MIDI parsing,
+// event handling or sending.
+//
+// Records below TT_LOG_LEVEL compile to nothing. When the ring is full a
+// record is dropped and counted; the flusher reports the count.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <atomic>
+#include "clock.h"
+
+#define TT_LOG_LEVEL_DEBUG 0
+#define TT_LOG_LEVEL_INFO 1
+#define TT_LOG_LEVEL_WARN 2
+#define TT_LOG_LEVEL_ERROR 3
+#define TT_LOG_LEVEL_NONE 4
+
+#ifndef TT_LOG_LEVEL
+#define TT_LOG_LEVEL TT_LOG_LEVEL_INFO
+#endif
+
+// Format strings take integer args only. Supported conversions: %u %d %x %X
+// (with optional zero-pad/width, e.g. %03u, %02X), %s for the record's static
+// string, %N for a MIDI note name (C4, F#2, ...) and %%. Conversions past the
+// last supplied arg are left out together with the spaces before them, so
+// one format can carry a variable count.
+#define TT_LOG_FORMATS(X) \
+    X(LF_NOTE_ON,          "Signal: true | Note: %N (%u) | Velocity: %u | State: ON") \
+    X(LF_NOTE_OFF,         "Signal: true | Note: %N (%u) | Velocity: %u | State: OFF | Duration: %u.%03u ms") \
+    X(LF_OFF_WITHOUT_ON,   "(info) Ignored OFF for note %u with no prior ON") \
+    X(LF_MIDI_DROPPED,     "(midi) event queue full: dropped %u note event(s) (%u total)") \
+    X(LF_RAW_MIDI,         "Raw MIDI bytes: %02X %02X %02X %02X %02X %02X") \
+    X(LF_PLAYING,          "Playing: true | Note: %N (%u) | Velocity: %u | Playing for: %ums") \
+    X(LF_NOT_PLAYING,      "Playing: false") \
+    X(LF_RX_PIN,           "RX pin state changed: %s") \
+    X(LF_RX_MALFORMED,     "(%s) dropped malformed %u-byte packet") \
+    X(LF_RX_STALE,         "(%s) dropped stale frame seq=%u (reordered=%u)") \
+    X(LF_RX_RESYNC,        "(%s) sender restarted, resynced at seq=%u (resyncs=%u)") \
+    X(LF_RX_LOST,          "(%s) lost %u frame(s) before seq=%u") \
+    X(LF_RX_NOTE_ON,       "(%s) Note: %N (%u) | Velocity: %u | State: ON") \
+    X(LF_RX_NOTE_OFF,      "(%s) Note: %N (%u) | State: OFF | Held: %u ms") \
+    X(LF_RX_NOTE_DURATION, "(%s) Note: %N (%u) | Duration: %u ms") \
+    X(LF_TX_NO_PEER,       "(%s) cannot send %u-byte packet: no peer") \
+    X(LF_TX_ERROR,         "ESP-NOW send error: %d") \
+    X(LF_LOOP_LOAD,        "(load) %s | %u loops/s | loop max %u us | tick %u.%u%% max %u us") \
+    X(LF_BOOT_FIRST_NOTE,  "(boot) first note shown %u ms after power-on (setup() done at %u ms)") \
+    X(LF_LOG_DROPPED,      "(log) dropped %u record(s)")
+
+// Defined in main.cpp; used to expand %N
+const char* midiNoteToName(uint8_t note);
+
+namespace Log {
+
+enum Level : uint8_t { LV_DEBUG = 0, LV_INFO, LV_WARN, LV_ERROR };
+
+#define TT_LOG_ENUM(id, str) id,
+enum Format : uint16_t { TT_LOG_FORMATS(TT_LOG_ENUM) LF_COUNT };
+#undef TT_LOG_ENUM
+
+#define TT_LOG_STRING(id, str) str,
+inline constexpr const char* FORMAT_STRINGS[LF_COUNT] = { TT_LOG_FORMATS(TT_LOG_STRING) };
+#undef TT_LOG_STRING
+
+constexpr size_t MAX_ARGS = 6;
+// Ring capacity in records (power of two)
+constexpr size_t RING_LEN = 128;
+// Longest formatted line, including the "[ms] " prefix
+constexpr size_t LINE_MAX = 160;
+
+struct Record {
+    uint32_t time_ms;
+    uint16_t format;
+    uint8_t level;
+    uint8_t nargs;
+    const char* str;          // static string for %s, or nullptr
+    uint32_t args[MAX_ARGS];
+};
+
+// Bounded lock-free multi-producer/single-consumer ring. Producers are the
+// ingest task, the render loop and the radio receive callbacks; only the
+// flusher pops. Each cell's sequence number tells producers and the consumer
+// whose turn it is, so a slow producer never exposes a half-written record.
+template <size_t Capacity>
+class Ring {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Log ring capacity must be a power of two");
+
+public:
+    Ring() {
+        for (size_t i = 0; i < Capacity; ++i) cells_[i].seq.store((uint32_t)i, std::memory_order_relaxed);
+    }
+
+    bool push(const Record& r) {
+        uint32_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& c = cells_[pos & (Capacity - 1)];
+            int32_t diff = (int32_t)(c.seq.load(std::memory_order_acquire) - pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    c.rec = r;
+                    c.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool pop(Record& out) {
+        uint32_t pos = tail_.load(std::memory_order_relaxed);
+        Cell& c = cells_[pos & (Capacity - 1)];
+        if ((int32_t)(c.seq.load(std::memory_order_acquire) - (pos + 1)) < 0) return false;
+        out = c.rec;
+        c.seq.store(pos + (uint32_t)Capacity, std::memory_order_release);
+        tail_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<uint32_t> seq;
+        Record rec;
+    };
+    Cell cells_[Capacity];
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint32_t> tail_{0};
+    std::atomic<uint32_t> dropped_{0};
+};
+
+inline Ring<RING_LEN> ring;
+// Drop count already reported by flush()
+inline uint32_t reportedDrops = 0;
+
+inline uint32_t dropped() { return ring.dropped(); }
+
+inline void putArg(Record& r, const char* s) { r.str = s; }
+template <typename T>
+inline void putArg(Record& r, T v) { if (r.nargs < MAX_ARGS) r.args[r.nargs++] = (uint32_t)v; }
+
+template <typename... A>
+inline void write(Level level, Format format, A... args) {
+    static_assert(sizeof...(A) <= MAX_ARGS, "too many log args");
+    Record r{ Clock::nowMs(), (uint16_t)format, (uint8_t)level, 0, nullptr, {} };
+    (putArg(r, args), ...);
+    ring.push(r);
+}
+
+// Record with a runtime number of integer args (e.g. a raw byte dump)
+inline void writeArgs(Level level, Format format, const uint32_t* args, size_t n) {
+    Record r{ Clock::nowMs(), (uint16_t)format, (uint8_t)level, 0, nullptr, {} };
+    for (size_t i = 0; i < n && i < MAX_ARGS; ++i) r.args[r.nargs++] = args[i];
+    ring.push(r);
+}
+
+// Expand a record into `out` (always NUL-terminated). Returns the length.
+inline size_t format(const Record& r, char* out, size_t cap) {
+    if (cap == 0) return 0;
+    size_t len = (size_t)snprintf(out, cap, "[%lu] ", (unsigned long)r.time_ms);
+    if (len >= cap) len = cap - 1;
+    const size_t prefix = len;
+    const char* f = r.format < LF_COUNT ? FORMAT_STRINGS[r.format] : "(log) unknown format";
+    size_t arg = 0;
+    auto append = [&](const char* s) {
+        while (*s && len + 1 < cap) out[len++] = *s++;
+    };
+    while (*f && len + 1 < cap) {
+        if (*f != '%') { out[len++] = *f++; continue; }
+        const char* spec = f++;
+        if (*f == '%') { out[len++] = '%'; ++f; continue; }
+        while (*f == '0' || (*f >= '1' && *f <= '9')) ++f;
+        char conv = *f ? *f++ : '\0';
+        if (conv == 's') { append(r.str ? r.str : "?"); continue; }
+        if (arg >= r.nargs) {
+            while (len > prefix && out[len - 1] == ' ') --len;
+            continue;
+        }
+        uint32_t v = r.args[arg++];
+        char tmp[24];
+        if (conv == 'N') {
+            append(midiNoteToName((uint8_t)v));
+            continue;
+        }
+        // Rebuild the spec with a long modifier, e.g. "%03u" -> "%03lu"
+        char one[12];
+        size_t n = 0;
+        for (const char* p = spec; p < f - 1 && n < sizeof(one) - 3; ++p) one[n++] = *p;
+        one[n++] = 'l';
+        one[n++] = conv;
+        one[n] = '\0';
+        if (conv == 'd') snprintf(tmp, sizeof(tmp), one, (long)(int32_t)v);
+        else snprintf(tmp, sizeof(tmp), one, (unsigned long)v);
+        append(tmp);
+    }
+    out[len] = '\0';
+    return len;
+}
+
+// Format and hand up to `maxRecords` records to `sink(const char* line)`,
+// reporting any drops since the last flush. Single consumer only.
+template <typename Sink>
+inline size_t flush(Sink&& sink, size_t maxRecords = RING_LEN) {
+    char line[LINE_MAX];
+    Record r;
+    size_t n = 0;
+    uint32_t drops = ring.dropped();
+    if (drops != reportedDrops) {
+        Record d{ Clock::nowMs(), LF_LOG_DROPPED, LV_WARN, 1, nullptr, {drops - reportedDrops} };
+        reportedDrops = drops;
+        format(d, line, sizeof(line));
+        sink(line);
+    }
+    while (n < maxRecords && ring.pop(r)) {
+        format(r, line, sizeof(line));
+        sink(line);
+        ++n;
+    }
+    return n;
+}
+
+} // namespace Log
+
+#if TT_LOG_LEVEL <= TT_LOG_LEVEL_DEBUG
+#define LOG_DEBUG(fmt, ...) Log::write(Log::LV_DEBUG, Log::fmt, ##__VA_ARGS__)
+#define LOG_DEBUG_ARGS(fmt, args, n) Log::writeArgs(Log::LV_DEBUG, Log::fmt, args, n)
+#else
+#define LOG_DEBUG(fmt, ...) do {} while (0)
+#define LOG_DEBUG_ARGS(fmt, args, n) do {} while (0)
+#endif
+#if TT_LOG_LEVEL <= TT_LOG_LEVEL_INFO
+#define LOG_INFO(fmt, ...) Log::write(Log::LV_INFO, Log::fmt, ##__VA_ARGS__)
+#else
+#define LOG_INFO(fmt, ...) do {} while (0)
+#endif
+#if TT_LOG_LEVEL <= TT_LOG_LEVEL_WARN
+#define LOG_WARN(fmt, ...) Log::write(Log::LV_WARN, Log::fmt, ##__VA_ARGS__)
+#else
+#define LOG_WARN(fmt, ...) do {} while (0)
+#endif
+#if TT_LOG_LEVEL <= TT_LOG_LEVEL_ERROR
+#define LOG_ERROR(fmt, ...) Log::write(Log::LV_ERROR, Log::fmt, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(fmt, ...) do {} while (0)
+#endif
@@ -0,0 +1,61 @@
+#pragma once
+
+// loop_load.h - how much of the loop() core the firmware is using. loop()
+// reports the length of each pass and of the Monalith::tick() inside it;
+// once per window the totals are turned into a report. Comparing reports
+// from builds with different display backends shows how much CPU each
+// leaves for MIDI handling. Both the render cost and the row scan of a
+// CPU-driven panel (PxMatrix, scanned by panel.refresh() on every tick())
+// show up as tick time, longer passes and fewer loops per second.
+
+#include <stdint.h>
+
+struct LoopLoad {
+    struct Report {
+        uint32_t loopsPerSec;
+        uint32_t avgLoopUs;
+        uint32_t maxLoopUs;
+        uint32_t tickPermille;   // share of wall time spent in Monalith::tick()
+        uint32_t maxTickUs;
+    };
+
+    // One loop() pass that took loopUs, tickUs of it in Monalith::tick()
+    void add(uint32_t loopUs, uint32_t tickUs) {
+        ++loops_;
+        loopUs_ += loopUs;
+        tickUs_ += tickUs;
+        if (loopUs > maxLoopUs_) maxLoopUs_ = loopUs;
+        if (tickUs > maxTickUs_) maxTickUs_ = tickUs;
+    }
+
+    // Fill out and start a new window once windowUs has passed since the
+    // last one. The first call only starts the window.
+    bool take(uint64_t nowUs, uint64_t windowUs, Report& out) {
+        if (!started_) {
+            started_ = true;
+            windowStartUs_ = nowUs;
+            return false;
+        }
+        uint64_t elapsed = nowUs - windowStartUs_;
+        if (elapsed < windowUs || elapsed == 0) return false;
+        out.loopsPerSec = (uint32_t)(loops_ * 1000000ull / elapsed);
+        out.avgLoopUs = loops_ ? (uint32_t)(loopUs_ / loops_) : 0;
+        out.maxLoopUs = maxLoopUs_;
+        out.tickPermille = (uint32_t)(tickUs_ * 1000ull / elapsed);
+        out.maxTickUs = maxTickUs_;
+        windowStartUs_ = nowUs;
+        loops_ = 0;
+        loopUs_ = tickUs_ = 0;
+        maxLoopUs_ = maxTickUs_ = 0;
+        return true;
+    }
+
+private:
+    bool started_ = false;
+    uint64_t windowStartUs_ = 0;
+    uint32_t loops_ = 0;
+    uint64_t loopUs_ = 0;
+    uint64_t tickUs_ = 0;
+    uint32_t maxLoopUs_ = 0;
+    uint32_t maxTickUs_ = 0;
+};
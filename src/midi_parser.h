@@ -0,0 +1,220 @@
+#pragma once
+
+// midi_parser.h - MIDI 1.0 byte-stream parser shared by the firmware ingest
+// path (main.cpp) and the host tests/benchmarks.
+//
+// Every byte is classified through a 256-entry table, and the next state and
+// action come from a [state][class] transition table. Both tables are built
+// at compile time. The parser follows the MIDI 1.0 stream rules:
+//   - Real-time bytes (0xF8..0xFF) are reported immediately and may appear
+//     between any two bytes without disturbing the message in progress.
+//   - Running status: data bytes after a completed channel message reuse its
+//     status. System common messages and SysEx cancel running status.
+//   - SysEx (0xF0 ... 0xF7) payloads are skipped; any status byte ends them.
+//   - Data bytes with no status to apply to are dropped.
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace Midi {
+
+enum MessageType : uint8_t {
+    MSG_NONE = 0,
+    MSG_NOTE_OFF,          // also NoteOn with velocity 0
+    MSG_NOTE_ON,
+    MSG_POLY_AFTERTOUCH,
+    MSG_CONTROL_CHANGE,
+    MSG_PROGRAM_CHANGE,
+    MSG_CHANNEL_AFTERTOUCH,
+    MSG_PITCH_BEND,
+    MSG_SYSTEM_COMMON,     // MTC quarter frame, song position/select, tune request
+    MSG_REALTIME,          // clock, start/continue/stop, active sensing, reset
+};
+
+struct Message {
+    uint8_t type;    // MessageType
+    uint8_t status;  // raw status byte (channel messages keep their channel nibble)
+    uint8_t channel; // 0..15 for channel messages, 0 otherwise
+    uint8_t data1;
+    uint8_t data2;
+
+    bool isNote() const { return type == MSG_NOTE_ON || type == MSG_NOTE_OFF; }
+    // Pitch bend value centred on 0 (-8192..8191)
+    int16_t pitchBend() const { return (int16_t)(((data2 << 7) | data1) - 8192); }
+};
+
+// Byte classes: the column index of the transition table.
+enum ByteClass : uint8_t {
+    BC_DATA = 0,     // 0x00..0x7F
+    BC_CHANNEL1,     // channel status with one data byte (0xCn, 0xDn)
+    BC_CHANNEL2,     // channel status with two data bytes (0x8n..0xBn, 0xEn)
+    BC_COMMON0,      // system common without data (0xF6 tune request, undefined 0xF4/0xF5)
+    BC_COMMON1,      // system common with one data byte (0xF1, 0xF3)
+    BC_COMMON2,      // system common with two data bytes (0xF2)
+    BC_SYSEX,        // 0xF0
+    BC_EOX,          // 0xF7
+    BC_REALTIME,     // 0xF8..0xFF
+    BC_COUNT
+};
+
+// Parser states: the row index of the transition table.
+enum ParseState : uint8_t {
+    PS_IDLE = 0,     // no running status; data bytes are dropped
+    PS_CH1_D1,       // one-byte channel message, waiting for data1
+    PS_CH2_D1,       // two-byte channel message, waiting for data1
+    PS_CH2_D2,       // two-byte channel message, waiting for data2
+    PS_SYS1_D1,      // one-byte system common, waiting for data1
+    PS_SYS2_D1,
+    PS_SYS2_D2,
+    PS_SYSEX,        // inside SysEx; data bytes are skipped
+    PS_COUNT
+};
+
+enum ParseAction : uint8_t {
+    PA_NONE = 0,     // drop the byte
+    PA_LATCH,        // remember a new status byte
+    PA_STORE1,       // remember data1
+    PA_EMIT1,        // data byte completes a one-data-byte message
+    PA_EMIT2,        // data byte completes a two-data-byte message
+    PA_EMIT_STATUS,  // status byte is a complete message on its own
+};
+
+struct ByteInfo {
+    uint8_t cls;     // ByteClass
+    uint8_t type;    // MessageType for status bytes
+};
+
+struct Transition {
+    uint8_t next;    // ParseState
+    uint8_t action;  // ParseAction
+};
+
+struct ByteTable { ByteInfo v[256]; };
+struct TransitionTable { Transition v[PS_COUNT][BC_COUNT]; };
+
+constexpr ByteTable makeByteTable() {
+    ByteTable t{};
+    for (int b = 0; b < 256; ++b) {
+        ByteInfo& e = t.v[b];
+        if (b < 0x80) { e = ByteInfo{BC_DATA, MSG_NONE}; continue; }
+        switch (b & 0xF0) {
+            case 0x80: e = ByteInfo{BC_CHANNEL2, MSG_NOTE_OFF}; continue;
+            case 0x90: e = ByteInfo{BC_CHANNEL2, MSG_NOTE_ON}; continue;
+            case 0xA0: e = ByteInfo{BC_CHANNEL2, MSG_POLY_AFTERTOUCH}; continue;
+            case 0xB0: e = ByteInfo{BC_CHANNEL2, MSG_CONTROL_CHANGE}; continue;
+            case 0xC0: e = ByteInfo{BC_CHANNEL1, MSG_PROGRAM_CHANGE}; continue;
+            case 0xD0: e = ByteInfo{BC_CHANNEL1, MSG_CHANNEL_AFTERTOUCH}; continue;
+            case 0xE0: e = ByteInfo{BC_CHANNEL2, MSG_PITCH_BEND}; continue;
+            default: break;
+        }
+        if (b >= 0xF8) e = ByteInfo{BC_REALTIME, MSG_REALTIME};
+        else if (b == 0xF0) e = ByteInfo{BC_SYSEX, MSG_NONE};
+        else if (b == 0xF7) e = ByteInfo{BC_EOX, MSG_NONE};
+        else if (b == 0xF1 || b == 0xF3) e = ByteInfo{BC_COMMON1, MSG_SYSTEM_COMMON};
+        else if (b == 0xF2) e = ByteInfo{BC_COMMON2, MSG_SYSTEM_COMMON};
+        else e = ByteInfo{BC_COMMON0, MSG_SYSTEM_COMMON};
+    }
+    return t;
+}
+
+constexpr TransitionTable makeTransitionTable() {
+    TransitionTable t{};
+    for (int s = 0; s < PS_COUNT; ++s) {
+        // Status bytes behave the same from every state (they also end SysEx)
+        t.v[s][BC_CHANNEL1] = Transition{PS_CH1_D1, PA_LATCH};
+        t.v[s][BC_CHANNEL2] = Transition{PS_CH2_D1, PA_LATCH};
+        t.v[s][BC_COMMON0] = Transition{PS_IDLE, PA_EMIT_STATUS};
+        t.v[s][BC_COMMON1] = Transition{PS_SYS1_D1, PA_LATCH};
+        t.v[s][BC_COMMON2] = Transition{PS_SYS2_D1, PA_LATCH};
+        t.v[s][BC_SYSEX] = Transition{PS_SYSEX, PA_NONE};
+        t.v[s][BC_EOX] = Transition{PS_IDLE, PA_NONE};
+        // Real-time bytes never change the state
+        t.v[s][BC_REALTIME] = Transition{(uint8_t)s, PA_EMIT_STATUS};
+    }
+    t.v[PS_IDLE][BC_DATA] = Transition{PS_IDLE, PA_NONE};
+    t.v[PS_CH1_D1][BC_DATA] = Transition{PS_CH1_D1, PA_EMIT1};   // running status
+    t.v[PS_CH2_D1][BC_DATA] = Transition{PS_CH2_D2, PA_STORE1};
+    t.v[PS_CH2_D2][BC_DATA] = Transition{PS_CH2_D1, PA_EMIT2};   // running status
+    t.v[PS_SYS1_D1][BC_DATA] = Transition{PS_IDLE, PA_EMIT1};
+    t.v[PS_SYS2_D1][BC_DATA] = Transition{PS_SYS2_D2, PA_STORE1};
+    t.v[PS_SYS2_D2][BC_DATA] = Transition{PS_IDLE, PA_EMIT2};
+    t.v[PS_SYSEX][BC_DATA] = Transition{PS_SYSEX, PA_NONE};
+    return t;
+}
+
+inline constexpr ByteTable BYTE_TABLE = makeByteTable();
+inline constexpr TransitionTable TRANSITIONS = makeTransitionTable();
+
+static_assert(BYTE_TABLE.v[0x93].cls == BC_CHANNEL2 && BYTE_TABLE.v[0x93].type == MSG_NOTE_ON, "note on class");
+static_assert(BYTE_TABLE.v[0xF8].cls == BC_REALTIME, "clock is real-time");
+static_assert(TRANSITIONS.v[PS_CH2_D2][BC_REALTIME].next == PS_CH2_D2, "real-time keeps state");
+
+class Parser {
+public:
+    // Feed one byte. Returns true and fills `out` when the byte completes a message.
+    bool push(uint8_t b, Message& out) {
+        const ByteInfo& info = BYTE_TABLE.v[b];
+        const Transition& tr = TRANSITIONS.v[state_][info.cls];
+        state_ = tr.next;
+        switch (tr.action) {
+            case PA_LATCH:
+                status_ = b;
+                type_ = info.type;
+                return false;
+            case PA_STORE1:
+                data1_ = b;
+                return false;
+            case PA_EMIT1:
+                out = make(b, 0);
+                return true;
+            case PA_EMIT2:
+                out = make(data1_, b);
+                return true;
+            case PA_EMIT_STATUS:
+                out = Message{info.type, b, 0, 0, 0};
+                return true;
+            default:
+                if (info.cls == BC_DATA && state_ == PS_SYSEX) ++sysexBytes_;
+                return false;
+        }
+    }
+
+    // Feed a buffer, calling `onMessage(const Message&)` for each completed
+    // message. SysEx payloads are skipped without going through the tables.
+    template <typename F>
+    void feed(const uint8_t* buf, size_t n, F&& onMessage) {
+        Message m;
+        for (size_t i = 0; i < n; ++i) {
+            if (state_ == PS_SYSEX) {
+                size_t start = i;
+                while (i < n && buf[i] < 0x80) ++i;
+                sysexBytes_ += (uint32_t)(i - start);
+                if (i == n) break;
+            }
+            if (push(buf[i], m)) onMessage(m);
+        }
+    }
+
+    void reset() { state_ = PS_IDLE; status_ = 0; type_ = MSG_NONE; data1_ = 0; }
+    ParseState state() const { return (ParseState)state_; }
+    // Running status currently applied to data bytes (0 if none)
+    uint8_t runningStatus() const { return state_ == PS_IDLE || state_ == PS_SYSEX ? 0 : status_; }
+    uint32_t sysexBytesSkipped() const { return sysexBytes_; }
+
+private:
+    Message make(uint8_t d1, uint8_t d2) const {
+        uint8_t type = type_;
+        // NoteOn with velocity 0 is a NoteOff (common with running status)
+        if (type == MSG_NOTE_ON && d2 == 0) type = MSG_NOTE_OFF;
+        uint8_t channel = status_ < 0xF0 ? (uint8_t)(status_ & 0x0F) : 0;
+        return Message{type, status_, channel, d1, d2};
+    }
+
+    uint8_t state_ = PS_IDLE;
+    uint8_t status_ = 0;
+    uint8_t type_ = MSG_NONE;
+    uint8_t data1_ = 0;
+    uint32_t sysexBytes_ = 0;
+};
+
+} // namespace Midi
@@ -0,0 +1,152 @@
+#pragma once
+
+// overlay_asset.h - compact storage for full-panel overlay images. A two
+// colour staff overlay needs one bit per pixel, not a 32-bit word or even
+// RGB565, so assets carry a small RGB565 palette and pixel indices:
+//
+//   OVERLAY_RGB565  2 bytes/pixel, no palette (photos, gradients)
+//   OVERLAY_MASK1   1 bit/pixel, 2-colour palette
+//   OVERLAY_PAL2    2 bits/pixel, up to 4 colours
+//   OVERLAY_PAL4    4 bits/pixel, up to 16 colours
+//   OVERLAY_RLE     runs of palette indices (up to 16 colours); one byte per
+//                   run of 1..15 pixels, two bytes for runs of 16..271
+//
+// Packed rows are MSB-first and padded to a whole byte; RLE runs continue
+// across rows. The decoders write RGB565 straight into a framebuffer.
+// Assets are generated by scripts/overlay_pack. The struct is plain C so
+// generated .c files (example_bitmap.c) compile in the Arduino build.
+// Also guarded by macro: midi_note_display/src/ carries a synced copy
+// (scripts/sync_sketch_headers.sh) that host tests can include alongside it.
+#ifndef TT_OVERLAY_ASSET_H
+#define TT_OVERLAY_ASSET_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+enum OverlayFormat {
+    OVERLAY_RGB565 = 0,
+    OVERLAY_MASK1 = 1,
+    OVERLAY_PAL2 = 2,
+    OVERLAY_PAL4 = 3,
+    OVERLAY_RLE = 4,
+};
+
+typedef struct OverlayAsset {
+    uint8_t format;           /* OverlayFormat */
+    uint8_t paletteSize;      /* entries in palette; 0 for OVERLAY_RGB565 */
+    uint16_t width;
+    uint16_t height;
+    const uint16_t* palette;  /* RGB565 */
+    const uint8_t* data;
+    uint32_t dataBytes;
+} OverlayAsset;
+
+#ifdef __cplusplus
+#include <string.h>
+
+namespace Overlay {
+
+// RLE: high nibble is run length - 1, low nibble the palette index; a high
+// nibble of RLE_EXTENDED means the next byte holds run length - RLE_LONG_MIN
+constexpr uint8_t RLE_EXTENDED = 0x0F;
+constexpr int RLE_LONG_MIN = 16;
+constexpr int RLE_MAX_RUN = RLE_LONG_MIN + 255;
+
+constexpr int bitsPerPixel(uint8_t format) {
+    return format == OVERLAY_MASK1 ? 1 : format == OVERLAY_PAL2 ? 2 : format == OVERLAY_PAL4 ? 4 : 0;
+}
+
+// Bytes one packed row takes (0 for RGB565 and RLE)
+constexpr size_t packedRowBytes(uint8_t format, int width) {
+    return ((size_t)width * bitsPerPixel(format) + 7) / 8;
+}
+
+// Flash the asset occupies: pixel data plus palette
+inline size_t storageBytes(const OverlayAsset& a) {
+    return a.dataBytes + (size_t)a.paletteSize * sizeof(uint16_t);
+}
+
+// One packed row to RGB565; the shift count is a constant per depth so
+// whole bytes unpack without a per-pixel loop test
+template <int Bpp>
+inline void unpackRow(const uint8_t* row, int w, const uint16_t* palette, uint16_t* out) {
+    constexpr int PER_BYTE = 8 / Bpp;
+    constexpr uint8_t MASK = (uint8_t)((1 << Bpp) - 1);
+    int x = 0;
+    for (; x + PER_BYTE <= w; x += PER_BYTE) {
+        uint8_t b = *row++;
+        for (int k = 0; k < PER_BYTE; ++k) out[x + k] = palette[(b >> (8 - Bpp * (k + 1))) & MASK];
+    }
+    if (x < w) {
+        uint8_t b = *row;
+        for (int k = 0; x < w; ++k, ++x) out[x] = palette[(b >> (8 - Bpp * (k + 1))) & MASK];
+    }
+}
+
+// Decode the whole asset into dst, `stride` pixels apart per row. Returns
+// false (dst partly written) when the data is too short or an index is
+// outside the palette.
+inline bool decode(const OverlayAsset& a, uint16_t* dst, int stride) {
+    const int w = a.width, h = a.height;
+    const uint8_t* p = a.data;
+    const uint8_t* end = a.data + a.dataBytes;
+    switch (a.format) {
+    case OVERLAY_RGB565: {
+        if (a.dataBytes < (size_t)w * h * 2) return false;
+        for (int y = 0; y < h; ++y) memcpy(dst + (size_t)y * stride, p + (size_t)y * w * 2, (size_t)w * 2);
+        return true;
+    }
+    case OVERLAY_MASK1:
+    case OVERLAY_PAL2:
+    case OVERLAY_PAL4: {
+        const int bpp = bitsPerPixel(a.format);
+        const size_t rowBytes = packedRowBytes(a.format, w);
+        if (a.dataBytes < rowBytes * h || a.paletteSize < 1) return false;
+        // every index a row can hold must be in the palette
+        if (a.paletteSize < (1 << bpp)) {
+            for (size_t i = 0; i < rowBytes * h; ++i)
+                for (int s = 8 - bpp; s >= 0; s -= bpp)
+                    if (((p[i] >> s) & ((1 << bpp) - 1)) >= a.paletteSize) return false;
+        }
+        for (int y = 0; y < h; ++y) {
+            const uint8_t* row = p + rowBytes * y;
+            uint16_t* out = dst + (size_t)y * stride;
+            if (bpp == 1) unpackRow<1>(row, w, a.palette, out);
+            else if (bpp == 2) unpackRow<2>(row, w, a.palette, out);
+            else unpackRow<4>(row, w, a.palette, out);
+        }
+        return true;
+    }
+    case OVERLAY_RLE: {
+        int x = 0, y = 0;
+        while (y < h) {
+            if (p >= end) return false;
+            uint8_t b = *p++;
+            int run = (b >> 4) + 1;
+            if ((b >> 4) == RLE_EXTENDED) {
+                if (p >= end) return false;
+                run = RLE_LONG_MIN + *p++;
+            }
+            uint8_t idx = b & 0x0F;
+            if (idx >= a.paletteSize) return false;
+            uint16_t c = a.palette[idx];
+            while (run > 0 && y < h) {
+                int n = w - x < run ? w - x : run;
+                uint16_t* out = dst + (size_t)y * stride + x;
+                for (int i = 0; i < n; ++i) out[i] = c;
+                run -= n;
+                x += n;
+                if (x == w) { x = 0; ++y; }
+            }
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+} // namespace Overlay
+#endif
+
+#endif // TT_OVERLAY_ASSET_H
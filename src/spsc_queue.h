@@ -0,0 +1,52 @@
+#pragma once
+
+// spsc_queue.h - fixed-capacity lock-free single-producer/single-consumer ring.
+// The MIDI ingest task (FreeRTOS on ESP32, std::thread on host) is the only
+// producer and the render loop is the only consumer. Built on std::atomic so
+// the same code runs on the ESP32 and in the host tests.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    // Producer side. Returns false (and counts a drop) when the ring is full.
+    bool push(const T& v) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        uint32_t tail = tail_.load(std::memory_order_acquire);
+        if ((uint32_t)(head - tail) >= Capacity) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        buf_[head & (Capacity - 1)] = v;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when the ring is empty.
+    bool pop(T& out) {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        uint32_t head = head_.load(std::memory_order_acquire);
+        if (head == tail) return false;
+        out = buf_[tail & (Capacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called from a thread other than producer/consumer.
+    size_t size() const { return (size_t)(uint32_t)(head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire)); }
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return Capacity; }
+    uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    T buf_[Capacity];
+    // Free-running indices; wraparound is handled by unsigned subtraction.
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint32_t> tail_{0};
+    std::atomic<uint32_t> dropped_{0};
+};
@@ -0,0 +1,296 @@
+#pragma once
+
+// staff_renderer.h - incremental renderer for the midi_note_display staff
+// sketch. The TeachTiles overlay is decoded to RGB565 once, and
+// that copy is what is saved under every note sprite: adding a note writes
+// only the note's own pixels, and erasing one restores just the background
+// pixels it covered. The whole panel is repainted only by redrawAll().
+// ScrollingStaff keeps the notes on the staff in a timestamped ring and
+// slides them left as new ones arrive by moving the whole note layer one
+// column at a time. Display is anything with
+// drawPixel(int16_t x, int16_t y, uint16_t rgb565) (MatrixPanel_I2S_DMA, or
+// a fake in host tests).
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace StaffRender {
+
+constexpr int WIDTH = 64;
+constexpr int HEIGHT = 64;
+constexpr size_t PIXELS = (size_t)WIDTH * HEIGHT;
+
+// Same values as the sketch's Accidental / OctaveShift enums
+enum Shape : uint8_t { SHAPE_NATURAL = 0, SHAPE_SHARP = 1, SHAPE_FLAT = 2 };
+enum Shift : uint8_t { SHIFT_NONE = 0, SHIFT_UP = 1, SHIFT_DOWN = 2 };
+
+struct Offset { int8_t dx, dy; };
+
+// Note heads, centred on the staff position:
+//   natural  XXX   sharp   X    flat  X X
+//            XXX          XXX          X
+//            XXX           X          X X
+constexpr Offset NATURAL_PX[] = {{-1, -1}, {0, -1}, {1, -1}, {-1, 0}, {0, 0}, {1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+constexpr Offset SHARP_PX[] = {{0, -1}, {-1, 0}, {0, 0}, {1, 0}, {0, 1}};
+constexpr Offset FLAT_PX[] = {{-1, -1}, {1, -1}, {0, 0}, {-1, 1}, {1, 1}};
+// Octave arrows: above the head when the note is really higher, below when lower
+constexpr Offset UP_PX[] = {{0, -4}, {-1, -3}, {0, -3}, {1, -3}};
+constexpr Offset DOWN_PX[] = {{-1, 3}, {0, 3}, {1, 3}, {0, 4}};
+
+struct Sprite {
+    int16_t x;
+    int16_t y;
+    uint16_t colour;   // RGB565
+    uint8_t shape;     // Shape
+    uint8_t shift;     // Shift
+};
+
+constexpr uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b) {
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+// One 0x00RRGGBB overlay pixel, inverted (white paper -> black panel)
+constexpr uint16_t invertedRgb565(uint32_t px) {
+    return rgb565((uint8_t)(255 - ((px >> 16) & 0xFF)), (uint8_t)(255 - ((px >> 8) & 0xFF)), (uint8_t)(255 - (px & 0xFF)));
+}
+
+// Call fn(x, y) for every on-panel pixel of the sprite
+template <typename Fn>
+inline void forEachPixel(const Sprite& s, Fn&& fn) {
+    auto run = [&](const Offset* px, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            int x = s.x + px[i].dx, y = s.y + px[i].dy;
+            if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) continue;
+            fn(x, y);
+        }
+    };
+    switch (s.shape) {
+        case SHAPE_SHARP: run(SHARP_PX, sizeof(SHARP_PX) / sizeof(SHARP_PX[0])); break;
+        case SHAPE_FLAT: run(FLAT_PX, sizeof(FLAT_PX) / sizeof(FLAT_PX[0])); break;
+        default: run(NATURAL_PX, sizeof(NATURAL_PX) / sizeof(NATURAL_PX[0])); break;
+    }
+    if (s.shift == SHIFT_UP) run(UP_PX, sizeof(UP_PX) / sizeof(UP_PX[0]));
+    else if (s.shift == SHIFT_DOWN) run(DOWN_PX, sizeof(DOWN_PX) / sizeof(DOWN_PX[0]));
+}
+
+template <typename Display>
+class Renderer {
+public:
+    // `background` is the inverted RGB565 overlay, WIDTH x HEIGHT row-major;
+    // it must outlive the renderer
+    void begin(Display* display, const uint16_t* background) {
+        display_ = display;
+        background_ = background;
+    }
+
+    // Sprite pixels outside columns [x0, x1) are neither drawn nor erased
+    // (the background is still repainted whole by redrawAll())
+    void setClip(int x0, int x1) {
+        clipX0_ = x0;
+        clipX1_ = x1;
+    }
+
+    // Repaint the panel: background, then every sprite moved dx columns
+    void redrawAll(const Sprite* sprites, int count, int dx = 0) {
+        for (int y = 0; y < HEIGHT; ++y)
+            for (int x = 0; x < WIDTH; ++x) put(x, y, background_[y * WIDTH + x]);
+        for (int i = 0; i < count; ++i) draw(sprites[i], dx);
+        ++fullRedraws_;
+    }
+
+    // Draw one sprite, moved dx columns, over whatever is on the panel
+    void draw(const Sprite& s, int dx = 0) {
+        forEachClipped(s, dx, [&](int x, int y) { put(x, y, s.colour); });
+    }
+
+    // Put the background back under a sprite moved dx columns
+    void erase(const Sprite& s, int dx = 0) {
+        forEachClipped(s, dx, [&](int x, int y) { put(x, y, background_[y * WIDTH + x]); });
+    }
+
+    uint32_t pixelsWritten() const { return pixelsWritten_; }
+    uint32_t fullRedraws() const { return fullRedraws_; }
+
+private:
+    template <typename Fn>
+    void forEachClipped(Sprite s, int dx, Fn&& fn) {
+        s.x = (int16_t)(s.x + dx);
+        forEachPixel(s, [&](int x, int y) {
+            if (x >= clipX0_ && x < clipX1_) fn(x, y);
+        });
+    }
+
+    void put(int x, int y, uint16_t c) {
+        display_->drawPixel((int16_t)x, (int16_t)y, c);
+        ++pixelsWritten_;
+    }
+
+    Display* display_ = nullptr;
+    const uint16_t* background_ = nullptr;
+    int clipX0_ = 0;
+    int clipX1_ = WIDTH;
+    uint32_t pixelsWritten_ = 0;
+    uint32_t fullRedraws_ = 0;
+};
+
+// Where notes go on the staff. Notes are `spacing` columns apart from
+// firstX; `visible` of them fit before the staff scrolls (or clears), and
+// one more must still fit inside [clipLeft, clipRight), where it waits
+// while the others slide over.
+struct StaffLayout {
+    int16_t firstX;
+    int16_t spacing;
+    int16_t visible;
+    int16_t clipLeft;
+    int16_t clipRight;
+};
+
+// Notes in arrival order, most recent Capacity of them, each with its sprite
+// and arrival time. Sprite x is in staff columns: it is fixed when the note
+// is added and the panel shows the staff `offset()` columns in, so
+// scrolling moves the note layer as a whole (erase at the old offset, draw
+// at the new) and never recomputes a sprite. A scroll starts at the newest
+// note's arrival time and advances one column every stepMs from tick();
+// a note arriving mid-scroll first completes the previous one.
+template <typename Display, int Capacity>
+class ScrollingStaff {
+public:
+    struct Note {
+        Sprite sprite;
+        uint32_t timeMs;
+    };
+
+    // scroll = false keeps the old behaviour: a full staff is cleared and
+    // the next note starts again at firstX
+    void begin(Renderer<Display>* renderer, const StaffLayout& layout, uint32_t stepMs, bool scroll) {
+        renderer_ = renderer;
+        layout_ = layout;
+        stepMs_ = stepMs;
+        scroll_ = scroll;
+        renderer_->setClip(layout_.clipLeft, layout_.clipRight);
+        reset();
+    }
+
+    // Add a note (sprite.x is ignored) and draw it. Returns true when the
+    // staff was cleared and the whole panel repainted.
+    bool add(Sprite s, uint32_t nowMs) {
+        bool cleared = false;
+        if (!scroll_ && onStaff_ >= layout_.visible) {
+            reset();
+            cleared = true;
+        }
+        if (offset_ < target_) moveTo(target_);
+        if (offset_ >= REBASE_COLUMNS) rebase();
+        s.x = (int16_t)nextX_;
+        nextX_ += layout_.spacing;
+        push(Note{s, nowMs});
+        ++onStaff_;
+        // The newest note settles in the last visible slot
+        int settled = s.x - (layout_.firstX + (layout_.visible - 1) * layout_.spacing);
+        if (scroll_ && settled > target_) {
+            scrollFrom_ = offset_;
+            target_ = settled;
+        }
+        if (cleared) redraw();
+        else renderer_->draw(s, -offset_);
+        if (stepMs_ == 0) tick(nowMs);
+        return cleared;
+    }
+
+    // Advance a scroll in progress; returns true when the notes moved
+    bool tick(uint32_t nowMs) {
+        if (offset_ >= target_ || size_ == 0) return false;
+        uint32_t elapsed = nowMs - newest().timeMs;
+        int want = stepMs_ ? scrollFrom_ + (int)(elapsed / stepMs_) : target_;
+        if (want > target_) want = target_;
+        if (want <= offset_) return false;
+        moveTo(want);
+        return true;
+    }
+
+    // Repaint the overlay and every note at the current offset
+    void redraw() {
+        renderer_->redrawAll(nullptr, 0);
+        for (int i = 0; i < size_; ++i) renderer_->draw(at(i).sprite, -offset_);
+    }
+
+    // Remove every note and start again at firstX
+    void clear() {
+        reset();
+        redraw();
+    }
+
+    int size() const { return size_; }
+    const Note& at(int i) const { return ring_[(head_ + i) % Capacity]; }   // oldest first
+    const Note& newest() const { return at(size_ - 1); }
+    int offset() const { return offset_; }
+    bool scrolling() const { return offset_ < target_; }
+    // How long a loop may sleep before tick() has a column to move: 0 when
+    // one is due, NO_STEP when no scroll is in progress
+    static constexpr uint32_t NO_STEP = 0xFFFFFFFFu;
+    uint32_t msUntilNextStep(uint32_t nowMs) const {
+        if (!scrolling() || size_ == 0) return NO_STEP;
+        uint32_t dueMs = newest().timeMs + (uint32_t)(offset_ - scrollFrom_ + 1) * stepMs_;
+        return (int32_t)(dueMs - nowMs) > 0 ? dueMs - nowMs : 0;
+    }
+    // Panel column of a note's centre right now
+    int screenX(const Note& n) const { return n.sprite.x - offset_; }
+
+private:
+    // Keep sprite columns well inside int16_t on a long session
+    static constexpr int REBASE_COLUMNS = 8192;
+
+    void reset() {
+        head_ = size_ = 0;
+        onStaff_ = 0;
+        nextX_ = layout_.firstX;
+        offset_ = target_ = scrollFrom_ = 0;
+    }
+
+    void push(const Note& n) {
+        if (size_ == Capacity) {
+            head_ = (head_ + 1) % Capacity;
+            --size_;
+        }
+        ring_[(head_ + size_) % Capacity] = n;
+        ++size_;
+    }
+
+    // Slide the note layer: erase everything at the old offset first so a
+    // note's old pixels never wipe out a neighbour's new ones
+    void moveTo(int offset) {
+        for (int i = 0; i < size_; ++i) renderer_->erase(at(i).sprite, -offset_);
+        offset_ = offset;
+        for (int i = 0; i < size_; ++i) renderer_->draw(at(i).sprite, -offset_);
+        // Notes that have slid completely past clipLeft are dropped
+        while (size_ > 0 && screenX(at(0)) + 1 < layout_.clipLeft) {
+            head_ = (head_ + 1) % Capacity;
+            --size_;
+        }
+    }
+
+    void rebase() {
+        for (int i = 0; i < size_; ++i) ring_[(head_ + i) % Capacity].sprite.x -= (int16_t)offset_;
+        nextX_ -= offset_;
+        target_ -= offset_;
+        scrollFrom_ -= offset_;
+        offset_ = 0;
+    }
+
+    Renderer<Display>* renderer_ = nullptr;
+    StaffLayout layout_{};
+    uint32_t stepMs_ = 0;
+    bool scroll_ = true;
+    Note ring_[Capacity] = {};
+    int head_ = 0;
+    int size_ = 0;
+    int onStaff_ = 0;     // notes added since the staff was last cleared
+    int nextX_ = 0;       // staff column of the next note
+    int offset_ = 0;      // staff column shown at panel column 0
+    int target_ = 0;      // offset the current scroll ends at
+    int scrollFrom_ = 0;  // offset the current scroll started from
+};
+
+static_assert(invertedRgb565(0x00FFFFFF) == 0 && invertedRgb565(0) == 0xFFFF, "overlay inversion");
+
+} // namespace StaffRender
@@ -3,10 +3,17 @@
 // teachtiles.h - shared definitions for TeachTiles firmware
 
 #include <stdint.h>
+#include <stddef.h>
 
 // Transport selection
 enum TransportMode { TM_BT = 0, TM_ESPNOW = 1, TM_UDP = 2 };
 
+// Wire format for notes sent to remote tiles
+//   WM_LEGACY_DURATION: 5-byte [note, duration ms BE32] sent when the note is released
+//   WM_STREAM_EVENTS:   NoteOn/NoteOff sent as they are parsed, batched into
+//                       sequence-numbered v2 frames (see src/wire_protocol.h)
+enum WireMode { WM_LEGACY_DURATION = 0, WM_STREAM_EVENTS = 1 };
+
 // MIDI UART settings
 constexpr int MIDI_RX_PIN = 16;
 constexpr int MIDI_BAUDRATE = 31250;
@@ -15,18 +22,83 @@ constexpr int MIDI_BAUDRATE = 31250;
 constexpr unsigned long STATUS_PRINT_INTERVAL_MS = 200;
 constexpr unsigned long RAW_MIDI_DUMP_MS = 500;
 constexpr unsigned long PIN_CHECK_INTERVAL_MS = 100;
+// Loop/display CPU load report (see src/loop_load.h)
+constexpr unsigned long LOOP_LOAD_REPORT_MS = 5000;
+
+// Overlay shown at boot when the assets partition has one by this name (see src/asset_partition.h)
+constexpr const char* ASSET_BOOT_OVERLAY = "boot";
+
+// Streamed events are held this long after the first one so a chord goes out as one frame
+constexpr uint32_t WIRE_COALESCE_MS = 3;
+
+// MIDI inputs. Each has its own parser and note-on table so interleaved traffic
+// from two keyboards (or a keyboard and the Pi bridge) is parsed independently;
+// the id travels with every event and in the v2 frame's source field.
+enum MidiSource : uint8_t { MS_DIN = 0, MS_USB = 1 };
+constexpr size_t MIDI_SOURCE_COUNT = 2;
+
+// A parsed, timestamped note message handed from the ingest task to the render loop
+struct MidiEvent {
+    uint8_t status;   // 0x9n NoteOn or 0x8n NoteOff (NoteOn velocity 0 arrives as 0x8n)
+    uint8_t note;
+    uint8_t velocity;
+    uint8_t source;   // MidiSource the message was parsed from
+    uint64_t time_us; // arrival time of the message's last byte
+};
 
-// MIDI parsing state
-enum MidiParseState { WAIT_STATUS, WAIT_NOTE, WAIT_VELOCITY };
+// A received MIDI byte stamped by the UART receive callback
+struct StampedByte {
+    uint8_t byte;
+    uint64_t time_us;
+};
+
+// One MIDI byte on the wire: 10 bits at 31250 baud
+constexpr uint32_t MIDI_BYTE_US = 320;
+// How often the ingest task polls the USB bridge when no UART bytes wake it
+constexpr uint32_t MIDI_USB_POLL_MS = 2;
+
+// Unit for note durations in streamed frames
+enum DurationUnit { DU_MS = 0, DU_US = 1 };
+inline uint32_t durationToUnit(uint64_t us, DurationUnit unit) {
+    uint64_t v = unit == DU_US ? us : (us + 500) / 1000;
+    if (v == 0) v = 1;
+    return v > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)v;
+}
+
+// Capacity of the ingest -> render ring (power of two)
+constexpr size_t MIDI_EVENT_QUEUE_LEN = 64;
+// FreeRTOS priority of the ingest task pinned to core 0
+constexpr int MIDI_INGEST_TASK_PRIORITY = 5;
+// How often the idle-priority task formats and prints deferred log records
+constexpr uint32_t LOG_FLUSH_INTERVAL_MS = 20;
 
 // Helper to format note names
 const char* midiNoteToName(uint8_t note);
 
 // Firmware entry points
 void sendNoteData(uint8_t note, uint32_t duration);
+// time_ms is the sender-clock time the event happened (the MIDI arrival
+// stamp); 0 stamps it with the current time
+void sendNoteEvent(uint8_t status, uint8_t note, uint8_t velocity, uint32_t duration = 0, uint8_t source = MS_DIN, uint32_t time_ms = 0);
+void flushNoteEvents(bool force);
+
+// MIDI ingest: parse bytes into the event queue (producer) and consume it (render loop)
+void processMidiByte(uint8_t byte, uint64_t t_us, uint8_t source = MS_DIN);
+void drainMidiEvents();
+// Poll the MIDI inputs inline (used when the ingest task is not running)
+void processIncomingMidi();
+// Start the dedicated ingest task (FreeRTOS on ESP32, std::thread on host).
+// While it runs, loop() only consumes events.
+bool startMidiIngestTask();
+#ifndef ESP32
+void stopMidiIngestTask();
+#endif
+void handleRemotePacket(const uint8_t* buf, size_t len, TransportMode from, const char* tag);
 
 // Transport selection at compile/runtime
 extern TransportMode transport;
+extern WireMode wireMode;
+extern DurationUnit durationUnit;
 
 // ESP-NOW peer MAC helper
 #ifdef ESP32
@@ -0,0 +1,232 @@
+#pragma once
+
+// wire_protocol.h - framed note-event protocol shared by the firmware
+// (main.cpp), the host bridge (midi2udp.cpp) and the tile receive paths.
+//
+// Version 2 frame (multi-byte fields big-endian):
+//   [0]     MAGIC (0xF5, an undefined MIDI status so it never starts a v1/legacy packet)
+//   [1]     VERSION (2)
+//   [2]     flags (FLAG_DURATION_US: durations are in microseconds instead of ms)
+//   [3]     event count (1..MAX_EVENTS)
+//   [4..5]  sequence number, incremented per frame
+//   [6..9]  sender timestamp in ms (time of the first event in the frame)
+//   then `count` events of EVENT_BYTES each:
+//   [0] type  [1] note  [2] velocity  [3] source id
+//   [4..5]  event time as ms offset from the frame timestamp
+//   [6..9]  duration in ms or us (NoteOff/NoteDuration, 0 otherwise)
+//
+// decodePacket() also accepts the older formats so mixed-firmware tiles keep working:
+//   v1 streamed event: [status (0x90/0x80), note, velocity]
+//   legacy:            [note, duration ms BE32]
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace WireProtocol {
+
+constexpr uint8_t MAGIC = 0xF5;
+constexpr uint8_t VERSION = 2;
+constexpr size_t HEADER_BYTES = 10;
+constexpr size_t EVENT_BYTES = 10;
+// ESP-NOW payloads are limited to 250 bytes; size frames so one always fits.
+constexpr size_t MAX_FRAME_BYTES = 250;
+constexpr size_t MAX_EVENTS = (MAX_FRAME_BYTES - HEADER_BYTES) / EVENT_BYTES; // 24
+constexpr size_t LEGACY_BYTES = 5;
+constexpr size_t V1_EVENT_BYTES = 3;
+
+// Frame flags
+constexpr uint8_t FLAG_DURATION_US = 0x01;
+
+enum EventType : uint8_t {
+    EV_NOTE_ON = 1,
+    EV_NOTE_OFF = 2,
+    EV_NOTE_DURATION = 3, // legacy: note already released, duration known
+};
+
+struct Event {
+    uint8_t type;
+    uint8_t note;
+    uint8_t velocity;
+    uint8_t source;
+    uint32_t time_ms;   // sender clock
+    uint32_t duration;  // for EV_NOTE_OFF / EV_NOTE_DURATION; unit per frame flags
+};
+
+struct FrameHeader {
+    uint8_t version;    // 0 = legacy 5-byte, 1 = 3-byte streamed, 2 = framed
+    uint8_t flags;
+    uint8_t count;
+    uint16_t seq;
+    uint32_t time_ms;
+};
+
+inline void putU16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)(v >> 8); p[1] = (uint8_t)v; }
+inline void putU32(uint8_t* p, uint32_t v) { p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16); p[2] = (uint8_t)(v >> 8); p[3] = (uint8_t)v; }
+inline uint16_t getU16(const uint8_t* p) { return (uint16_t)((p[0] << 8) | p[1]); }
+inline uint32_t getU32(const uint8_t* p) { return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3]; }
+
+// Encode `n` events into a v2 frame. The frame timestamp is the first event's
+// time. Returns the frame length, or 0 if `n` is out of range or `cap` is too small.
+inline size_t encodeFrame(uint16_t seq, uint8_t flags, const Event* ev, size_t n, uint8_t* out, size_t cap) {
+    if (n == 0 || n > MAX_EVENTS) return 0;
+    size_t len = HEADER_BYTES + n * EVENT_BYTES;
+    if (cap < len) return 0;
+    uint32_t t0 = ev[0].time_ms;
+    out[0] = MAGIC;
+    out[1] = VERSION;
+    out[2] = flags;
+    out[3] = (uint8_t)n;
+    putU16(out + 4, seq);
+    putU32(out + 6, t0);
+    uint8_t* p = out + HEADER_BYTES;
+    for (size_t i = 0; i < n; ++i, p += EVENT_BYTES) {
+        uint32_t dt = ev[i].time_ms - t0;
+        p[0] = ev[i].type;
+        p[1] = ev[i].note;
+        p[2] = ev[i].velocity;
+        p[3] = ev[i].source;
+        putU16(p + 4, dt > 0xFFFF ? 0xFFFF : (uint16_t)dt);
+        putU32(p + 6, ev[i].duration);
+    }
+    return len;
+}
+
+// Total length of the packet that starts with `buf`, or 0 if more bytes are
+// needed before it can be known. Used to frame packets on byte streams (BT SPP).
+inline size_t packetLength(const uint8_t* buf, size_t avail) {
+    if (avail == 0) return 0;
+    if (buf[0] == MAGIC) {
+        if (avail < HEADER_BYTES) return 0;
+        size_t count = buf[3];
+        // Malformed count: report what we have so the caller drops it and resyncs
+        if (count == 0 || count > MAX_EVENTS) return avail;
+        return HEADER_BYTES + count * EVENT_BYTES;
+    }
+    return (buf[0] & 0x80) ? V1_EVENT_BYTES : LEGACY_BYTES;
+}
+
+// Event duration in milliseconds regardless of the frame's unit flag.
+inline uint32_t durationMs(const FrameHeader& h, const Event& ev) {
+    return (h.flags & FLAG_DURATION_US) ? (ev.duration + 500) / 1000 : ev.duration;
+}
+
+// Reassembles packets from a byte stream (BT SPP) one byte at a time.
+struct StreamFramer {
+    uint8_t buf[MAX_FRAME_BYTES];
+    size_t len = 0;
+
+    // Append a byte. Returns the packet length once a complete packet is in
+    // `buf` (valid until the next push), else 0.
+    size_t push(uint8_t b) {
+        buf[len++] = b;
+        size_t need = packetLength(buf, len);
+        if ((need && len >= need) || len >= sizeof(buf)) {
+            size_t n = len;
+            len = 0;
+            return n;
+        }
+        return 0;
+    }
+};
+
+// Decode any supported packet format into events. Fills `h` (version 0/1 for
+// the older formats) and returns the number of events written to `out`, or 0
+// if the packet is malformed.
+inline size_t decodePacket(const uint8_t* buf, size_t len, FrameHeader& h, Event* out, size_t maxOut) {
+    h = FrameHeader{0, 0, 0, 0, 0};
+    if (len == 0 || maxOut == 0) return 0;
+    if (buf[0] == MAGIC) {
+        if (len < HEADER_BYTES || buf[1] != VERSION) return 0;
+        h.version = buf[1];
+        h.flags = buf[2];
+        h.count = buf[3];
+        h.seq = getU16(buf + 4);
+        h.time_ms = getU32(buf + 6);
+        if (h.count == 0 || h.count > MAX_EVENTS || len < HEADER_BYTES + h.count * EVENT_BYTES) return 0;
+        size_t n = h.count < maxOut ? h.count : maxOut;
+        const uint8_t* p = buf + HEADER_BYTES;
+        for (size_t i = 0; i < n; ++i, p += EVENT_BYTES) {
+            out[i].type = p[0];
+            out[i].note = p[1] & 0x7F;
+            out[i].velocity = p[2] & 0x7F;
+            out[i].source = p[3];
+            out[i].time_ms = h.time_ms + getU16(p + 4);
+            out[i].duration = getU32(p + 6);
+        }
+        return n;
+    }
+    if (buf[0] & 0x80) {
+        if (len < V1_EVENT_BYTES) return 0;
+        h.version = 1;
+        h.count = 1;
+        bool on = (buf[0] & 0xF0) == 0x90 && (buf[2] & 0x7F) > 0;
+        out[0] = Event{ (uint8_t)(on ? EV_NOTE_ON : EV_NOTE_OFF), (uint8_t)(buf[1] & 0x7F), (uint8_t)(buf[2] & 0x7F), 0, 0, 0 };
+        return 1;
+    }
+    if (len < LEGACY_BYTES) return 0;
+    h.count = 1;
+    out[0] = Event{ EV_NOTE_DURATION, buf[0], 100, 0, 0, getU32(buf + 1) };
+    return 1;
+}
+
+// Sender-side batcher: collects events for up to `window_ms` after the first
+// one so a chord goes out as a single frame.
+struct FrameBatcher {
+    Event pending[MAX_EVENTS];
+    size_t count = 0;
+    uint16_t seq = 0;
+    uint8_t flags = 0;
+
+    // Queue an event. Returns true when the batch is full and must be flushed.
+    bool add(const Event& ev) {
+        if (count < MAX_EVENTS) pending[count++] = ev;
+        return count >= MAX_EVENTS;
+    }
+    bool due(uint32_t now_ms, uint32_t window_ms) const {
+        return count > 0 && (now_ms - pending[0].time_ms) >= window_ms;
+    }
+    // Encode the pending events into `out` and reset. Returns the frame length.
+    size_t flush(uint8_t* out, size_t cap) {
+        size_t len = encodeFrame(seq, flags, pending, count, out, cap);
+        if (len) ++seq;
+        count = 0;
+        return len;
+    }
+};
+
+// Receiver-side sequence tracking for v2 frames: counts lost frames and
+// rejects duplicates/reordered frames that arrive after a newer one. A frame
+// more than REORDER_WINDOW behind, or any frame behind after RESYNC_IDLE_MS
+// of silence, means the sender restarted its counter: tracking resyncs to it
+// instead of dropping everything until the old sequence is passed again.
+// Frames ahead after a pause are ordinary traffic and still count loss.
+struct SeqTracker {
+    static constexpr int16_t REORDER_WINDOW = 64;
+    static constexpr uint32_t RESYNC_IDLE_MS = 1000;
+
+    bool have = false;
+    uint16_t last = 0;
+    uint32_t lastMs = 0;
+    uint32_t lost = 0;
+    uint32_t reordered = 0;
+    uint32_t resyncs = 0;
+
+    // Returns true if the frame should be applied.
+    bool accept(uint16_t seq, uint32_t nowMs) {
+        int16_t diff = (int16_t)(uint16_t)(seq - last);
+        bool idle = nowMs - lastMs >= RESYNC_IDLE_MS;
+        lastMs = nowMs;
+        if (!have) { have = true; last = seq; return true; }
+        if (diff < -REORDER_WINDOW || (idle && diff <= 0)) {
+            ++resyncs;
+            last = seq;
+            return true;
+        }
+        if (diff <= 0) { ++reordered; return false; }
+        lost += (uint32_t)(diff - 1);
+        last = seq;
+        return true;
+    }
+};
+
+} // namespace WireProtocol
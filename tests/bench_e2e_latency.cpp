@@ -0,0 +1,135 @@
+// End-to-end latency benchmark for the host build: MIDI bytes pushed into
+// HostSerial2 are parsed by main.cpp, sent through the loopback transport
+// (captured SerialBT packets), decoded by handleRemotePacket() and rendered
+// into the Monalith host framebuffer. Reports p50/p99/p99.9 per stage and end
+// to end, plus events/second, for both wire modes. Firmware time runs on the
+// virtual clock, advanced one Monalith frame period per message, so every
+// render stage sample is a full composed and presented frame.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+#include "../src/teachtiles.h"
+#include "../src/host_stubs.h"
+#include "../src/clock.h"
+#include "monalith.h"
+extern void setup();
+extern HostSerial2 Serial2;
+extern HostBT SerialBT;
+
+using BenchClock = std::chrono::steady_clock;
+
+static uint64_t elapsedNs(BenchClock::time_point a, BenchClock::time_point b) {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count();
+}
+
+enum Stage { ST_PARSE, ST_SEND, ST_DECODE, ST_RENDER, ST_E2E, ST_COUNT };
+static const char* STAGE_NAMES[ST_COUNT] = { "parse", "send", "decode", "render", "end-to-end" };
+
+struct Result {
+    std::vector<uint64_t> ns[ST_COUNT];
+    uint64_t totalNs = 0;
+    size_t events = 0;
+    size_t packets = 0;
+};
+
+static uint64_t percentile(std::vector<uint64_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t i = (size_t)(p * (double)(v.size() - 1) + 0.5);
+    std::nth_element(v.begin(), v.begin() + i, v.end());
+    return v[i];
+}
+
+// One MIDI message per iteration, alternating NoteOn/NoteOff across the keyboard.
+static Result run(WireMode mode, size_t messages) {
+    wireMode = mode;
+    Result r;
+    for (auto& v : r.ns) v.reserve(messages);
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < messages; ++i) {
+        uint8_t note = (uint8_t)(21 + (i / 2) % 88);
+        bool on = (i % 2) == 0;
+        Serial2.push(std::vector<uint8_t>{ (uint8_t)(on ? 0x90 : 0x80), note, (uint8_t)(on ? 100 : 0) });
+        Clock::advanceUs(Monalith::framePeriodUs());
+
+        auto t0 = BenchClock::now();
+        processIncomingMidi();
+        auto t1 = BenchClock::now();
+        drainMidiEvents();
+        flushNoteEvents(true);
+        auto t2 = BenchClock::now();
+        const auto& caps = SerialBT.getCaptured();
+        for (const auto& pkt : caps) handleRemotePacket(pkt.data(), pkt.size(), TM_BT, "bench");
+        r.packets += caps.size();
+        SerialBT.clear();
+        auto t3 = BenchClock::now();
+        Monalith::tick();
+        auto t4 = BenchClock::now();
+
+        r.ns[ST_PARSE].push_back(elapsedNs(t0, t1));
+        r.ns[ST_SEND].push_back(elapsedNs(t1, t2));
+        r.ns[ST_DECODE].push_back(elapsedNs(t2, t3));
+        r.ns[ST_RENDER].push_back(elapsedNs(t3, t4));
+        r.ns[ST_E2E].push_back(elapsedNs(t0, t4));
+    }
+    r.totalNs = elapsedNs(start, BenchClock::now());
+    r.events = messages;
+    return r;
+}
+
+static void report(const char* label, Result& r) {
+    std::printf("%s: %zu MIDI messages, %zu packets, %.0f events/s\n", label, r.events, r.packets,
+                r.totalNs ? (double)r.events * 1e9 / (double)r.totalNs : 0.0);
+    std::printf("  %-11s %10s %10s %10s\n", "stage", "p50 us", "p99 us", "p99.9 us");
+    for (int s = 0; s < ST_COUNT; ++s) {
+        std::printf("  %-11s %10.2f %10.2f %10.2f\n", STAGE_NAMES[s],
+                    percentile(r.ns[s], 0.50) / 1000.0, percentile(r.ns[s], 0.99) / 1000.0, percentile(r.ns[s], 0.999) / 1000.0);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t messages = argc > 1 ? (size_t)std::strtoul(argv[1], nullptr, 10) : 20000;
+
+    // The firmware logs every note; send that to /dev/null while measuring
+    // (run_benchmarks.sh also builds Monalith without its per-note trace)
+    std::fflush(stdout);
+    int savedStdout = dup(STDOUT_FILENO);
+    int devNull = open("/dev/null", O_WRONLY);
+    dup2(devNull, STDOUT_FILENO);
+
+    Clock::useVirtual(1000000);
+    setup();
+    Result legacy = run(WM_LEGACY_DURATION, messages);
+    Result stream = run(WM_STREAM_EVENTS, messages);
+
+    // Leave one note held so the framebuffer check below has something to find
+    Serial2.push(std::vector<uint8_t>{0x90, 60, 127});
+    processIncomingMidi();
+    drainMidiEvents();
+    flushNoteEvents(true);
+    for (const auto& pkt : SerialBT.getCaptured()) handleRemotePacket(pkt.data(), pkt.size(), TM_BT, "bench");
+    SerialBT.clear();
+    Clock::advanceUs(Monalith::framePeriodUs());
+    Monalith::tick();
+
+    std::fflush(stdout);
+    dup2(savedStdout, STDOUT_FILENO);
+    close(devNull);
+    close(savedStdout);
+
+    size_t lit = 0;
+    const uint16_t* fb = Monalith::hostFramebuffer();
+    for (int i = 0; i < 64 * 64; ++i) if (fb[i]) ++lit;
+    if (lit == 0 || stream.packets == 0 || legacy.packets == 0) {
+        std::printf("bench_e2e_latency: pipeline produced no output (packets legacy=%zu stream=%zu, lit pixels=%zu)\n",
+                    legacy.packets, stream.packets, lit);
+        return 1;
+    }
+
+    report("legacy (sendNoteData on release)", legacy);
+    report("stream (v2 frames, NoteOn/NoteOff)", stream);
+    return 0;
+}
@@ -0,0 +1,73 @@
+// Glyph drawing benchmark: the bit-by-bit drawGlyphAt() Monalith used to run
+// (one bit test and scale x scale pixel writes per font bit) against span
+// blits from the compile-time glyph atlas, both into the compositor's
+// annotation layer. Reports note-name labels drawn per second.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "compositor.h"
+#include "glyph_atlas.h"
+#include "../src/note_tables.h"
+
+using BenchClock = std::chrono::steady_clock;
+using Monalith::Layer;
+namespace Glyphs = Monalith::Glyphs;
+
+static Monalith::Compositor<64, 64> layers;
+
+// Copy of Monalith's previous drawGlyphAt(), without the per-pixel map printout
+static void legacyGlyph(int x0, int y0, const uint8_t* glyph, uint16_t colour, int scale) {
+    for (int gy = 0; gy < 8; ++gy) {
+        for (int gx = 0; gx < 8; ++gx) {
+            if (!(glyph[gy] & (1 << (7 - gx)))) continue;
+            for (int sy = 0; sy < scale; ++sy)
+                for (int sx = 0; sx < scale; ++sx)
+                    layers.set(Layer::Annotations, x0 + gx * scale + sx, y0 + gy * scale + sy, colour);
+        }
+    }
+}
+
+template <int Scale>
+static void atlasText(int x0, int y0, const char* text, uint16_t colour) {
+    for (const char* c = text; *c; ++c, x0 += Glyphs::SIZE * Scale) {
+        Glyphs::blit<Scale>(Glyphs::forChar(*c), x0, y0, [&](int x, int y, int n) {
+            layers.fillSpan(Layer::Annotations, x, y, n, colour);
+        });
+    }
+}
+
+template <typename Draw>
+static double run(int labels, Draw&& draw) {
+    auto t0 = BenchClock::now();
+    for (int i = 0; i < labels; ++i) {
+        // alternate colours so every label really rewrites its pixels
+        layers.clear(Layer::Annotations);
+        draw((uint8_t)(21 + i % 88), (uint16_t)(0xF800 | (i & 1)));
+    }
+    double secs = std::chrono::duration<double>(BenchClock::now() - t0).count();
+    return labels / secs;
+}
+
+template <int Scale>
+static void compare(int labels) {
+    double legacy = run(labels, [](uint8_t note, uint16_t colour) {
+        int x = 1;
+        for (const char* c = NoteTables::NAME[note].s; *c; ++c, x += 8 * Scale)
+            legacyGlyph(x, 1, Glyphs::FONT[Glyphs::forChar(*c)], colour, Scale);
+    });
+    double spans = run(labels, [](uint8_t note, uint16_t colour) {
+        atlasText<Scale>(1, 1, NoteTables::NAME[note].s, colour);
+    });
+    std::printf("  scale %d  bitwise %10.0f labels/s   spans %10.0f labels/s  (%.1fx)\n", Scale, legacy, spans, spans / legacy);
+}
+
+int main(int argc, char** argv) {
+    int labels = argc > 1 ? std::atoi(argv[1]) : 200000;
+    std::printf("Note name labels (\"C#4\"-style, %d per run):\n", labels);
+    compare<1>(labels);
+    compare<2>(labels);
+    compare<3>(labels);
+    std::printf("  atlas flash: %zu bytes at scale 1, %zu at scale 2\n",
+                sizeof(Glyphs::SPANS<1>), sizeof(Glyphs::SPANS<2>));
+    return 0;
+}
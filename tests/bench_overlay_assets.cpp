@@ -0,0 +1,68 @@
+// Overlay asset benchmark: for each shipped overlay, the flash every format
+// takes and the time to decode it into a 64x64 RGB565 framebuffer, next to
+// the arrays they replace (the staff overlay as inverted 0x00RRGGBB words,
+// the example bitmap as a plain RGB565 copy).
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "../scripts/overlay_encode.h"
+#include "../src/staff_renderer.h"
+#include "../midi_note_display/teachtiles_overlay.h"
+
+extern const OverlayAsset example_overlay;   // example_bitmap.c
+
+using BenchClock = std::chrono::steady_clock;
+
+static uint16_t framebuffer[64 * 64];
+static volatile uint16_t sink;
+
+template <typename Fn>
+static double usPerDecode(int reps, Fn&& fn) {
+    auto t0 = BenchClock::now();
+    for (int i = 0; i < reps; ++i) {
+        fn();
+        sink = framebuffer[i & 4095];
+    }
+    return std::chrono::duration<double, std::micro>(BenchClock::now() - t0).count() / reps;
+}
+
+static void report(const char* name, const OverlayAsset& shipped, bool inverted, int reps) {
+    std::vector<uint16_t> px(64 * 64);
+    Overlay::decode(shipped, px.data(), 64);
+    std::printf("%s (%zu colours)\n", name, overlayPalette(px.data(), 64, 64).size());
+    std::printf("  %-16s %8s %12s\n", "format", "bytes", "us/decode");
+
+    // What the overlay used to be
+    if (inverted) {
+        std::vector<uint32_t> argb(64 * 64);
+        for (size_t i = 0; i < argb.size(); ++i) {
+            uint16_t c = (uint16_t)~px[i];
+            argb[i] = ((uint32_t)((c >> 8) & 0xF8) << 16) | ((uint32_t)((c >> 3) & 0xFC) << 8) | (uint32_t)((c << 3) & 0xF8);
+        }
+        double us = usPerDecode(reps, [&] {
+            for (size_t i = 0; i < argb.size(); ++i) framebuffer[i] = StaffRender::invertedRgb565(argb[i]);
+        });
+        std::printf("  %-16s %8zu %12.2f\n", "argb32 (before)", argb.size() * 4, us);
+    } else {
+        double us = usPerDecode(reps, [&] { memcpy(framebuffer, px.data(), sizeof(framebuffer)); });
+        std::printf("  %-16s %8zu %12.2f\n", "rgb565 (before)", px.size() * 2, us);
+    }
+
+    for (int f = OVERLAY_RGB565; f <= OVERLAY_RLE; ++f) {
+        EncodedOverlay e;
+        if (!encodeOverlay(px.data(), 64, 64, f, e)) continue;
+        OverlayAsset a = e.asset();
+        double us = usPerDecode(reps, [&] { Overlay::decode(a, framebuffer, 64); });
+        std::printf("  %-16s %8zu %12.2f%s\n", overlayFormatName(f), e.bytes(), us,
+                    f == shipped.format ? "   <- shipped" : "");
+    }
+}
+
+int main(int argc, char** argv) {
+    int reps = argc > 1 ? std::atoi(argv[1]) : 20000;
+    report("midi_note_display/teachtiles_overlay.h", teachtiles_overlay, true, reps);
+    report("example_bitmap.c", example_overlay, false, reps);
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Colour lookup benchmark: the per-pixel integer HSV -> RGB565 conversion
+// Monalith used to run for every plotted pixel, against one read from the
+// constexpr palette table. Reports pixels/second over a trail-like stream of
+// (pitch class, brightness) pairs.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "palette.h"
+
+using BenchClock = std::chrono::steady_clock;
+
+// Copy of Monalith's previous hsvToRgb() + RGB565 pack (no gamma)
+static uint16_t legacy565(uint8_t H, uint8_t S, uint8_t V) {
+    uint8_t r, g, b;
+    uint8_t region = H / 43;
+    uint8_t remainder = (H - (region * 43)) * 6;
+    uint8_t p = (V * (255 - S)) >> 8;
+    uint8_t q = (V * (255 - ((S * remainder) >> 8))) >> 8;
+    uint8_t t = (V * (255 - ((S * (255 - remainder)) >> 8))) >> 8;
+    switch (region) {
+        case 0: r = V; g = t; b = p; break;
+        case 1: r = q; g = V; b = p; break;
+        case 2: r = p; g = V; b = t; break;
+        case 3: r = p; g = q; b = V; break;
+        case 4: r = t; g = p; b = V; break;
+        default: r = V; g = p; b = q; break;
+    }
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+struct Sample { uint8_t note; uint8_t level; };
+
+template <typename F>
+static double run(const std::vector<Sample>& s, int passes, F&& colour, uint32_t& sink) {
+    auto t0 = BenchClock::now();
+    uint32_t acc = 0;
+    for (int p = 0; p < passes; ++p) {
+        for (const Sample& x : s) acc += colour(x);
+    }
+    double secs = std::chrono::duration<double>(BenchClock::now() - t0).count();
+    sink += acc;
+    return (double)s.size() * passes / secs;
+}
+
+int main(int argc, char** argv) {
+    int passes = argc > 1 ? std::atoi(argv[1]) : 200;
+    std::vector<Sample> samples(1 << 16);
+    uint32_t rng = 2024;
+    for (Sample& x : samples) {
+        rng = rng * 1664525u + 1013904223u;
+        x.note = (uint8_t)(21 + (rng >> 16) % 88);
+        x.level = (uint8_t)(rng >> 8);
+    }
+
+    uint32_t sink = 0;
+    double legacy = run(samples, passes, [](const Sample& x) {
+        return legacy565(NoteTables::HUE[x.note], 200, x.level);
+    }, sink);
+    double lut = run(samples, passes, [](const Sample& x) {
+        return Monalith::Palette::RGB565[Monalith::Palette::row(x.note)][x.level];
+    }, sink);
+
+    std::printf("Note colour lookup over %zu pixels x %d:\n", samples.size(), passes);
+    std::printf("  HSV -> RGB565 per pixel   %8.1f Mpixel/s\n", legacy / 1e6);
+    std::printf("  Palette::RGB565 lookup    %8.1f Mpixel/s  (gamma %.1f included)\n", lut / 1e6, (double)MONALITH_GAMMA);
+    std::printf("  (checksum %u)\n", sink);
+    return 0;
+}
@@ -0,0 +1,52 @@
+// Monalith render benchmark on the host framebuffer backend: cost of one
+// tick() that composes and presents a frame, for a busy keyboard (every voice
+// decaying) over a black background and over a static bitmap, in frames/second.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../src/clock.h"
+#include "monalith.h"
+
+using BenchClock = std::chrono::steady_clock;
+
+static double run(int frames, bool bitmap) {
+    static uint16_t background[64 * 64];
+    for (int i = 0; i < 64 * 64; ++i) background[i] = (uint16_t)(i * 31);
+    Clock::useVirtual(1000000);
+    Monalith::init();
+    if (bitmap) Monalith::showStaticBitmap(background);
+    auto t0 = BenchClock::now();
+    for (int f = 0; f < frames; ++f) {
+        // retrigger a few notes every frame so the pool stays full and decaying
+        for (int k = 0; k < 4; ++k) Monalith::showNote((uint8_t)(21 + (f * 4 + k) % 88), 40, (uint8_t)(60 + k * 16));
+        Clock::advanceUs(Monalith::framePeriodUs());
+        Monalith::tick();
+    }
+    double secs = std::chrono::duration<double>(BenchClock::now() - t0).count();
+    return frames / secs;
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 20000;
+    // Other host output goes to /dev/null while measuring; run_benchmarks.sh
+    // builds Monalith without its per-note trace
+    std::fflush(stdout);
+    int savedStdout = dup(STDOUT_FILENO);
+    int devNull = open("/dev/null", O_WRONLY);
+    dup2(devNull, STDOUT_FILENO);
+    double black = run(frames, false);
+    double bitmap = run(frames, true);
+    Monalith::PresentStats st = Monalith::presentStats();
+    std::fflush(stdout);
+    dup2(savedStdout, STDOUT_FILENO);
+    close(devNull);
+    close(savedStdout);
+
+    std::printf("Monalith render (host backend, %d frames, %zu voices):\n", frames, Monalith::activeVoiceCount());
+    std::printf("  notes over black          %10.0f frames/s\n", black);
+    std::printf("  notes over static bitmap  %10.0f frames/s  (%.1f pixels pushed/frame)\n", bitmap,
+                st.framesPresented ? (double)st.pixelsPushed / st.framesPresented : 0.0);
+    return 0;
+}
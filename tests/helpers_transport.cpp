@@ -2,3 +2,5 @@
 
 // Provide a transport definition for host unit tests.
 TransportMode transport = TM_ESPNOW;
+// Existing tests check the legacy note+duration packets; streaming tests switch at runtime.
+WireMode wireMode = WM_LEGACY_DURATION;
@@ -0,0 +1,17 @@
+#!/usr/bin/env bash
+set -euo pipefail
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+OUTDIR="$ROOT/build/bench"
+mkdir -p "$OUTDIR"
+
+for f in "$ROOT"/tests/bench_*.cpp; do
+  name=$(basename "$f" .cpp)
+  out="$OUTDIR/$name"
+  echo "Compiling $name..."
+  # Benchmarks build optimized and link the real Monalith visualizer, which
+  # renders into its host framebuffer backend when no panel library is present,
+  # without the per-note trace printf
+  /usr/bin/g++ -O2 -std=c++17 -I"$ROOT" -I"$ROOT/monalith" -DTEST_RUNNER -DENABLE_MONALITH=1 -DMONALITH_NOTE_TRACE=0 -o "$out" "$f" "$ROOT/main.cpp" "$ROOT/monalith/monalith.cpp" "$ROOT/tests/helpers_transport.cpp" "$ROOT/example_bitmap.c" -pthread
+  echo "Running $name..."
+  "$out" "$@"
+done
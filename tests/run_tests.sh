@@ -4,14 +4,17 @@ ROOT="$(cd "$(dirname "$0")/.." && pwd)"
 OUTDIR="$ROOT/build/tests"
 mkdir -p "$OUTDIR"
 
+# The midi_note_display sketch builds from its own copies of the shared headers
+"$ROOT/scripts/sync_sketch_headers.sh" --check
+
 for f in "$ROOT"/tests/test_*.cpp; do
   name=$(basename "$f" .cpp)
   out="$OUTDIR/$name"
   echo "Compiling $name..."
   # Link the test with main.cpp and test helper that defines host-side symbols
-  # Disable Monalith to avoid hardware dependencies during host-side testing
+  # Monalith renders into its host framebuffer backend, so no panel hardware is needed
   # Include example_bitmap.c for the symbol reference in main.cpp
-  /usr/bin/g++ -g -std=c++17 -I"$ROOT" -I"$ROOT/monalith" -DTEST_RUNNER -DENABLE_MONALITH=0 -o "$out" "$f" "$ROOT/main.cpp" "$ROOT/tests/helpers_transport.cpp" "$ROOT/example_bitmap.c" -pthread
+  /usr/bin/g++ -g -std=c++17 -I"$ROOT" -I"$ROOT/monalith" -DTEST_RUNNER -DENABLE_MONALITH=1 -o "$out" "$f" "$ROOT/main.cpp" "$ROOT/monalith/monalith.cpp" "$ROOT/tests/helpers_transport.cpp" "$ROOT/example_bitmap.c" -pthread
   echo "Running $name..."
   "$out"
 done
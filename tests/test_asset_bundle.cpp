@@ -0,0 +1,107 @@
+// Test the overlay bundle for the assets partition: scripts/bundle_encode.h
+// output opens as an AssetBundle::View, found assets point into the bundle
+// (no copy) and decode to the source images, and erased, truncated or
+// corrupted bundles are rejected
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "../src/clock.h"
+#include "monalith.h"
+#include "../scripts/bundle_encode.h"
+#include "../src/asset_partition.h"
+
+static bool inside(const void* p, const std::vector<uint8_t>& buf) {
+    const uint8_t* b = static_cast<const uint8_t*>(p);
+    return b >= buf.data() && b < buf.data() + buf.size();
+}
+
+int main() {
+    using namespace AssetBundle;
+    assert(crc32((const uint8_t*)"123456789", 9) == 0xCBF43926u);
+
+    // A two-colour staff, three-colour stripes and a small image only RGB565 holds
+    std::vector<uint16_t> staff(64 * 64, 0x0000), stripes(64 * 64);
+    for (int y = 11; y < 60; y += 4) for (int x = 0; x < 64; ++x) staff[y * 64 + x] = 0xFFFF;
+    for (int i = 0; i < 64 * 64; ++i) stripes[i] = (uint16_t)(0xF800 >> (i % 3 * 5));
+    std::vector<uint16_t> photo(16 * 8);
+    for (size_t i = 0; i < photo.size(); ++i) photo[i] = (uint16_t)(i * 37);
+
+    std::vector<NamedOverlay> items = {
+        {"boot", encodeSmallestOverlay(staff.data(), 64, 64)},
+        {"stripes", encodeSmallestOverlay(stripes.data(), 64, 64)},
+        {"photo", encodeSmallestOverlay(photo.data(), 16, 8)},
+    };
+    assert(items[0].overlay.format == OVERLAY_RLE && items[2].overlay.format == OVERLAY_RGB565);
+    std::vector<uint8_t> bundle = buildAssetBundle(items);
+    assert(!bundle.empty() && bundle.size() % 4 == 0);
+
+    // Found assets decode to the source images straight from the bundle
+    View view;
+    assert(view.open(bundle.data(), bundle.size()) == OK);
+    assert(view.count() == 3 && view.bytes() == bundle.size());
+    const std::vector<uint16_t>* sources[] = {&staff, &stripes, &photo};
+    for (uint16_t i = 0; i < view.count(); ++i) {
+        OverlayAsset a;
+        char name[NAME_LEN];
+        assert(view.at(i, a, name));
+        assert(std::string(name) == items[i].name);
+        assert(inside(a.data, bundle) && inside(a.data + a.dataBytes - 1, bundle));
+        assert(!a.palette || inside(a.palette, bundle));
+        std::vector<uint16_t> out((size_t)a.width * a.height);
+        assert(Overlay::decode(a, out.data(), a.width));
+        assert(out == *sources[i]);
+    }
+    OverlayAsset found;
+    assert(view.find("stripes", found) && found.width == 64);
+    assert(!view.find("strip", found) && !view.find("missing", found));
+    assert(!view.at(3, found));
+
+    // A larger partition around the bundle is fine; the partition is mapped whole
+    std::vector<uint8_t> partition(0x4000, 0xFF);
+    memcpy(partition.data(), bundle.data(), bundle.size());
+    assert(view.open(partition.data(), partition.size()) == OK && view.bytes() == bundle.size());
+
+    // Erased flash, a missing partition and damaged bundles are rejected
+    std::vector<uint8_t> erased(0x4000, 0xFF);
+    assert(view.open(erased.data(), erased.size()) == NO_BUNDLE && !view.valid() && view.count() == 0);
+    assert(!view.find("boot", found));
+    assert(view.open(nullptr, 0) == NO_BUNDLE);
+    assert(view.open(bundle.data(), bundle.size() - 1) == TRUNCATED);
+    std::vector<uint8_t> bad = bundle;
+    bad.back() ^= 1;
+    assert(view.open(bad.data(), bad.size()) == BAD_CRC);
+    bad = bundle;
+    bad[4] = 2;
+    assert(view.open(bad.data(), bad.size()) == BAD_VERSION);
+    // An entry pointing past the end, even with a valid CRC
+    bad = bundle;
+    Entry e;
+    memcpy(&e, bad.data() + sizeof(Header), sizeof(e));
+    e.dataBytes = (uint32_t)bad.size();
+    memcpy(bad.data() + sizeof(Header), &e, sizeof(e));
+    Header h;
+    memcpy(&h, bad.data(), sizeof(h));
+    h.crc = crc32(bad.data() + sizeof(Header), bad.size() - sizeof(Header));
+    memcpy(bad.data(), &h, sizeof(h));
+    assert(view.open(bad.data(), bad.size()) == BAD_ENTRY);
+    assert(std::string(statusName(BAD_ENTRY)) == "bad entry");
+
+    // Names must fit and be unique
+    assert(buildAssetBundle({{"a_very_long_name", items[0].overlay}}).empty());
+    assert(buildAssetBundle({{"boot", items[0].overlay}, {"boot", items[1].overlay}}).empty());
+    assert(!buildAssetBundle({}).empty());
+
+    // The host build has no partition
+    assert(AssetPartition::mount(view) == NO_BUNDLE);
+
+    // Monalith shows an overlay decoded straight out of the bundle
+    assert(view.open(bundle.data(), bundle.size()) == OK && view.find("boot", found));
+    Clock::useVirtual(0);
+    Monalith::init();
+    assert(Monalith::showStaticOverlay(found));
+    assert(memcmp(Monalith::hostFramebuffer(), staff.data(), 64 * 64 * 2) == 0);
+
+    std::cout << "Test asset_bundle passed\n";
+    return 0;
+}
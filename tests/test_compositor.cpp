@@ -0,0 +1,88 @@
+// Test Monalith's layer compositor: background, note and annotation layers
+// stack with 0 as transparent, only dirty rows are recomposed, and a glyph
+// no longer stops notes from rendering underneath it
+#include <cassert>
+#include <iostream>
+#include "../src/clock.h"
+#include "monalith.h"
+#include "compositor.h"
+
+static size_t pixelsOf(const uint16_t* fb, uint16_t c) {
+    size_t n = 0;
+    for (int i = 0; i < 64 * 64; ++i) if (fb[i] == c) ++n;
+    return n;
+}
+
+int main() {
+    using Monalith::Layer;
+    // Compositor mechanics on a small canvas
+    static Monalith::FrameBuffer565<4, 3> canvas;
+    static Monalith::Compositor<4, 3> layers;
+    uint16_t bg[12];
+    for (int i = 0; i < 12; ++i) bg[i] = 0x1111;
+    layers.setBackground(bg);
+    assert(layers.compose(canvas) == 3);
+    assert(canvas.get(0, 0) == 0x1111 && canvas.get(3, 2) == 0x1111);
+    assert(!layers.dirty());
+
+    // A note pixel only dirties its own row; an annotation covers the note
+    layers.set(Layer::Notes, 1, 1, 0x2222);
+    layers.set(Layer::Notes, 2, 1, 0x2222);
+    layers.set(Layer::Annotations, 2, 1, 0x3333);
+    assert(layers.dirtyRows().count() == 1 && layers.dirtyRows().test(1));
+    assert(layers.compose(canvas) == 1);
+    assert(canvas.get(0, 1) == 0x1111 && canvas.get(1, 1) == 0x2222 && canvas.get(2, 1) == 0x3333);
+    // Rewriting the same pixel is not a change
+    layers.set(Layer::Notes, 1, 1, 0x2222);
+    assert(!layers.dirty());
+    // Clearing a layer recomposes only the rows it used; the note shows again
+    layers.clear(Layer::Annotations);
+    assert(layers.compose(canvas) == 1);
+    assert(canvas.get(2, 1) == 0x2222);
+    layers.clear(Layer::Notes);
+    layers.clear(Layer::Notes);
+    assert(layers.compose(canvas) == 1);
+    assert(canvas.get(1, 1) == 0x1111 && canvas.get(2, 1) == 0x1111);
+    layers.set(Layer::Notes, 4, 0, 0xFFFF);   // out of range: ignored
+    assert(!layers.dirty());
+
+    // Monalith: a note over a static bitmap pushes only the note's pixels
+    Clock::useVirtual(1000000);
+    Monalith::init();
+    static uint16_t bitmap[64 * 64];
+    for (int i = 0; i < 64 * 64; ++i) bitmap[i] = 0x0841;
+    Monalith::showStaticBitmap(bitmap);
+    Monalith::resetPresentStats();
+    Monalith::showNote(60, Monalith::DURATION_HELD, 100);
+    Clock::advanceUs(Monalith::framePeriodUs());
+    Monalith::tick();
+    Monalith::PresentStats st = Monalith::presentStats();
+    assert(st.framesPresented == 1 && st.pixelsPushed == 5);
+    assert(pixelsOf(Monalith::hostFramebuffer(), 0x0841) == 64 * 64 - 5);
+
+    // The glyph is drawn over the notes and the bitmap at once
+    Monalith::drawCSharp(500);
+    const uint16_t* fb = Monalith::hostFramebuffer();
+    size_t red = pixelsOf(fb, 0xF800), white = pixelsOf(fb, 0xFFFF);
+    assert(red > 0 && white > 0);
+    // While it is shown, a new note still renders beneath it
+    Monalith::showNote(40, Monalith::DURATION_HELD, 100);
+    Clock::advanceUs(Monalith::framePeriodUs());
+    Monalith::tick();
+    fb = Monalith::hostFramebuffer();
+    assert(pixelsOf(fb, 0xF800) == red && pixelsOf(fb, 0xFFFF) == white);
+    assert(pixelsOf(fb, 0x0841) < 64 * 64 - 5 - red - white);
+
+    // When the glyph expires the bitmap and both notes are left
+    Clock::advanceMs(500);
+    Monalith::tick();
+    fb = Monalith::hostFramebuffer();
+    assert(pixelsOf(fb, 0x0841) == 64 * 64 - 10);
+
+    // Clearing the bitmap leaves the notes on black
+    Monalith::clearStaticBitmap();
+    assert(pixelsOf(Monalith::hostFramebuffer(), 0) == 64 * 64 - 10);
+
+    std::cout << "Test compositor passed\n";
+    return 0;
+}
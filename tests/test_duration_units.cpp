@@ -0,0 +1,48 @@
+// Test microsecond timestamping: streamed durations can be sent in us, legacy packets stay in ms
+#include <cassert>
+#include <iostream>
+#include "../src/teachtiles.h"
+#include "../src/wire_protocol.h"
+#include "../src/clock.h"
+#include "../src/host_stubs.h"
+extern void setup();
+extern void loop();
+extern HostSerial2 Serial2;
+extern HostBT SerialBT;
+
+int main() {
+    Clock::useVirtual(1000000);
+    setup();
+    assert(durationToUnit(1499, DU_MS) == 1 && durationToUnit(1500, DU_MS) == 2);
+    assert(durationToUnit(0, DU_US) == 1 && durationToUnit(1234, DU_US) == 1234);
+
+    // Bytes are stamped individually: the NoteOn is stamped before the hold, the NoteOff after it
+    processMidiByte(0x90, 1000);
+    processMidiByte(60, 1320);
+    processMidiByte(100, 1640);
+    processMidiByte(0x80, 26000);
+    processMidiByte(60, 26320);
+    processMidiByte(0, 26640);
+    loop();
+    auto caps = SerialBT.getCaptured();
+    assert(caps.size() == 1);
+    uint32_t ms = ((uint32_t)caps[0][1] << 24) | ((uint32_t)caps[0][2] << 16) | ((uint32_t)caps[0][3] << 8) | caps[0][4];
+    assert(ms == 25); // 25000 us rounded to ms
+
+    wireMode = WM_STREAM_EVENTS;
+    durationUnit = DU_US;
+    Serial2.push(std::vector<uint8_t>{0x90, 62, 90});
+    for (int i = 0; i < 4; ++i) { loop(); Clock::advanceMs(5); }
+    Serial2.push(std::vector<uint8_t>{0x80, 62, 0});
+    for (int i = 0; i < 4; ++i) { loop(); Clock::advanceMs(5); }
+    caps = SerialBT.getCaptured();
+    assert(caps.size() == 3);
+    WireProtocol::FrameHeader h;
+    WireProtocol::Event ev[WireProtocol::MAX_EVENTS];
+    assert(WireProtocol::decodePacket(caps[2].data(), caps[2].size(), h, ev, WireProtocol::MAX_EVENTS) == 1);
+    assert(h.flags & WireProtocol::FLAG_DURATION_US);
+    assert(ev[0].type == WireProtocol::EV_NOTE_OFF && ev[0].duration == 20000);
+    std::cout << "duration=" << ev[0].duration << " us\n";
+    std::cout << "Test duration_units passed\n";
+    return 0;
+}
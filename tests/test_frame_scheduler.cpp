@@ -0,0 +1,64 @@
+// Test Monalith's fixed-timestep scheduler: trail decay depends on elapsed
+// time rather than on how often tick() runs, rendering is capped at the
+// target frame rate, and late frames are reported as missed
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include "../src/clock.h"
+#include "monalith.h"
+
+static uint16_t pixel;
+
+// Play one short note, tick every `tickMs` for 40 ms, then sample the note's pixel
+static Monalith::SchedulerStats playAndSample(uint32_t tickMs) {
+    Clock::useVirtual(5000000);
+    Monalith::init();
+    Monalith::tick();
+    Monalith::showNote(60, 50, 127);
+    for (uint32_t t = 0; t < 40; t += tickMs) { Clock::advanceMs(tickMs); Monalith::tick(); }
+    Monalith::SchedulerStats st = Monalith::schedulerStats();
+    // Step into the next frame slot (one more simulation step) and render
+    Clock::advanceUs(Monalith::framePeriodUs());
+    Monalith::tick();
+    pixel = Monalith::hostFramebuffer()[32 * 64 + 28];  // C4's main pixel
+    return st;
+}
+
+int main() {
+    assert(Monalith::targetFps() == 60 && Monalith::framePeriodUs() == 16666);
+
+    // A fast loop and a sluggish loop leave the trail at the same brightness
+    Monalith::SchedulerStats fast = playAndSample(1);
+    uint16_t fastPixel = pixel;
+    Monalith::SchedulerStats slow = playAndSample(40);
+    uint16_t slowPixel = pixel;
+    assert(fastPixel != 0 && fastPixel == slowPixel);
+    assert(fast.simSteps == 4 && slow.simSteps == 4);
+
+    // Rendering is capped: 40 ticks in 40 ms give the first frame plus two more
+    assert(fast.frames == 3 && fast.framesMissed == 0);
+    // A single tick after 40 ms has let the 16.7 ms slot pass
+    assert(slow.frames == 2 && slow.framesMissed == 1 && slow.maxLateUs > 0);
+
+    // A long stall does not replay hundreds of simulation steps
+    Clock::useVirtual(9000000);
+    Monalith::init();
+    Monalith::tick();
+    Clock::advanceMs(5000);
+    Monalith::tick();
+    Monalith::SchedulerStats st = Monalith::schedulerStats();
+    assert(st.simSteps == 32 && st.simStepsDropped == 500 - 32);
+    assert(st.framesMissed == (5000000 - 16666) / 16666);   // every slot before the one just rendered
+
+    // Uncapped: every tick renders
+    Monalith::setTargetFps(0);
+    Monalith::resetSchedulerStats();
+    for (int i = 0; i < 10; ++i) Monalith::tick();
+    assert(Monalith::schedulerStats().frames == 10);
+    Monalith::setTargetFps(30);
+    assert(Monalith::framePeriodUs() == 33333);
+    Monalith::setTargetFps(60);
+
+    std::cout << "Test frame_scheduler passed\n";
+    return 0;
+}
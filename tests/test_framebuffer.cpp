@@ -0,0 +1,96 @@
+// Test Monalith's double-buffered RGB565 canvas: drawing lands in the back
+// buffer and only becomes visible when tick() presents the frame; unchanged
+// frames are skipped and only changed spans reach the backend
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include "../src/clock.h"
+#include "monalith.h"
+#include "framebuffer.h"
+
+static size_t litPixels(const uint16_t* fb) {
+    size_t n = 0;
+    for (int i = 0; i < 64 * 64; ++i) if (fb[i]) ++n;
+    return n;
+}
+
+int main() {
+    // FrameBuffer565 mechanics on a small canvas
+    Monalith::FrameBuffer565<4, 2> small;
+    small.set(1, 1, 0x1234);
+    small.set(4, 0, 0xFFFF);   // out of range: ignored
+    small.set(-1, 0, 0xFFFF);
+    assert(small.shown()[1 * 4 + 1] == 0);
+    const uint16_t* before = small.shown();
+    int pushes = 0;
+    using SmallRows = Monalith::FrameBuffer565<4, 2>::Rows;
+    bool ok = small.present([&](const uint16_t* frame, const uint16_t* prev, const SmallRows& dirty) {
+        ++pushes;
+        assert(frame[5] == 0x1234 && prev[5] == 0);
+        for (int i = 0; i < 8; ++i) if (i != 5) assert(frame[i] == 0);
+        assert(!dirty.test(0) && dirty.test(1) && dirty.count() == 1);
+    });
+    assert(ok && pushes == 1 && small.frames() == 1);
+    assert(small.shown() != before);               // buffers flipped
+    assert(small.get(1, 1) == 0x1234);             // back buffer carries the frame over
+    // Rewriting identical pixels is not a new frame
+    small.set(1, 1, 0x1234);
+    small.fill(0);
+    small.set(1, 1, 0x1234);
+    assert(!small.present([&](const uint16_t*, const uint16_t*, const SmallRows&) { ++pushes; }));
+    assert(pushes == 1 && small.skipped() == 1);
+    small.fill(0xABCD);
+    for (int i = 0; i < 8; ++i) assert(small.shown()[i] != 0xABCD);
+    // A 40-row mask spans two words
+    Monalith::RowMask<40> tall;
+    tall.set(39);
+    assert(tall.any() && tall.test(39) && !tall.test(7) && tall.count() == 1);
+
+    // Monalith on the host renders into the canvas
+    Clock::useVirtual(1000000);
+    Monalith::init();
+    Monalith::setTargetFps(0);   // every tick is a frame, so each one is presented or skipped
+    Monalith::tick();
+    const uint16_t* fb = Monalith::hostFramebuffer();
+    assert(litPixels(fb) == 0);
+
+    // showNote draws into the back buffer; the visible frame is untouched until tick()
+    Monalith::showNote(60, Monalith::DURATION_HELD, 100);
+    assert(litPixels(Monalith::hostFramebuffer()) == 0);
+    Monalith::resetPresentStats();
+    Monalith::tick();
+    fb = Monalith::hostFramebuffer();
+    assert(litPixels(fb) == 5);   // main pixel plus its four-pixel spread
+    Monalith::PresentStats st = Monalith::presentStats();
+    assert(st.framesPresented == 1 && st.pixelsPushed == 5);  // only the changed spans reach the panel
+
+    // A held note does not change: later ticks present nothing
+    for (int i = 0; i < 100; ++i) { Clock::advanceMs(10); Monalith::tick(); }
+    st = Monalith::presentStats();
+    assert(st.framesPresented == 1 && st.framesSkipped == 100);
+    assert(st.panelRefreshes == 101);   // but the backend is refreshed on every tick
+    assert(st.pixelsPerSecond == 5);   // one frame in the last second
+
+    // Releasing lets the trail decay to black over a few frames
+    Monalith::releaseNote(60);
+    for (int i = 0; i < 40; ++i) { Clock::advanceMs(10); Monalith::tick(); }
+    assert(Monalith::activeVoiceCount() == 0);
+    assert(litPixels(Monalith::hostFramebuffer()) == 0);
+
+    // A static bitmap is presented in one blit and stays as the background
+    static uint16_t bitmap[64 * 64];
+    for (int i = 0; i < 64 * 64; ++i) bitmap[i] = (uint16_t)(i * 7);
+    Monalith::showStaticBitmap(bitmap);
+    assert(std::memcmp(Monalith::hostFramebuffer(), bitmap, sizeof(bitmap)) == 0);
+    Monalith::showNote(72, 50, 127);
+    Monalith::tick();
+    fb = Monalith::hostFramebuffer();
+    assert(std::memcmp(fb, bitmap, sizeof(bitmap)) != 0);
+    for (int i = 0; i < 40; ++i) { Clock::advanceMs(10); Monalith::tick(); }
+    assert(std::memcmp(Monalith::hostFramebuffer(), bitmap, sizeof(bitmap)) == 0);
+    Monalith::clearStaticBitmap();
+    assert(litPixels(Monalith::hostFramebuffer()) == 0);
+
+    std::cout << "Test framebuffer passed\n";
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Test the glyph atlas: the compile-time spans cover exactly the font's lit
+// pixels at every scale, characters map to glyphs, and Monalith labels the
+// newest note with its name on the annotation layer
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include "../src/clock.h"
+#include "monalith.h"
+#include "glyph_atlas.h"
+
+using namespace Monalith::Glyphs;
+
+template <int Scale>
+static void checkScale() {
+    const int n = SIZE * Scale;
+    for (int g = 0; g < COUNT; ++g) {
+        bool grid[n][n];
+        memset(grid, 0, sizeof(grid));
+        blit<Scale>((Glyph)g, 0, 0, [&](int x, int y, int len) {
+            assert(len > 0 && x + len <= n && y < n);
+            for (int i = 0; i < len; ++i) {
+                assert(!grid[y][x + i]);   // spans never overlap
+                grid[y][x + i] = true;
+            }
+        });
+        for (int y = 0; y < n; ++y) {
+            for (int x = 0; x < n; ++x) {
+                bool lit = (FONT[g][y / Scale] >> (7 - x / Scale)) & 1;
+                assert(grid[y][x] == lit);
+            }
+        }
+    }
+    assert(SPANS<Scale>.first[COUNT] == fontRuns() * Scale);
+}
+
+static size_t pixelsOf(const uint16_t* fb, uint16_t c, int rows) {
+    size_t n = 0;
+    for (int i = 0; i < 64 * rows; ++i) if (fb[i] == c) ++n;
+    return n;
+}
+
+int main() {
+    checkScale<1>();
+    checkScale<2>();
+    checkScale<3>();
+    assert(forChar('A') == G_A && forChar('G') == G_G && forChar('H') == NONE);
+    assert(forChar('b') == G_FLAT && forChar('n') == G_NATURAL && forChar('-') == G_MINUS);
+    assert(forChar('0') == G_0 && forChar('^') == G_UP && forChar('>') == G_RIGHT);
+    // The original C glyph: one 4-pixel run on top, two 2-pixel runs below it
+    assert(SPANS<1>.first[G_C + 1] - SPANS<1>.first[G_C] == 1 + 2 + 1 + 1 + 1 + 1 + 2 + 1);
+    // Characters without a glyph draw nothing
+    int calls = 0;
+    blit<1>(NONE, 0, 0, [&](int, int, int) { ++calls; });
+    assert(calls == 0);
+
+    // Monalith labels the newest note in the top-left corner
+    Clock::useVirtual(1000000);
+    Monalith::init();
+    Monalith::showNoteNames(true);
+    Monalith::showNote(61, Monalith::DURATION_HELD, 100);   // C#4, drawn well below the label
+    Clock::advanceUs(Monalith::framePeriodUs());
+    Monalith::tick();
+    const uint16_t* fb = Monalith::hostFramebuffer();
+    size_t c4 = 0;
+    for (int y = 0; y < 10; ++y)
+        for (int x = 0; x < 30; ++x) c4 += fb[y * 64 + x] != 0;
+    // 'C', '#' and '4' lit pixels at scale 1
+    size_t expected = 0;
+    for (char ch : {'C', '#', '4'})
+        for (int y = 0; y < SIZE; ++y)
+            for (uint8_t b = FONT[forChar(ch)][y]; b; b &= b - 1) ++expected;
+    assert(c4 == expected);
+    // A newer note replaces the label; a different name lights different pixels
+    Clock::advanceMs(5);
+    Monalith::showNote(69, Monalith::DURATION_HELD, 100);   // A4
+    Clock::advanceUs(Monalith::framePeriodUs());
+    Monalith::tick();
+    size_t a4 = 0;
+    for (int y = 0; y < 10; ++y)
+        for (int x = 0; x < 30; ++x) a4 += fb[y * 64 + x] != 0;
+    assert(a4 != c4 && a4 > 0);
+    // Turning labels off clears them once the notes are gone
+    Monalith::showNoteNames(false);
+    Clock::advanceUs(Monalith::framePeriodUs());
+    Monalith::tick();
+    assert(pixelsOf(Monalith::hostFramebuffer(), 0, 9) == 64 * 9);
+
+    std::cout << "Test glyph_atlas passed\n";
+    return 0;
+}
@@ -1,8 +1,7 @@
 // Test: note-off without prior note-on should be ignored (no BT packet)
 #include <cassert>
 #include <iostream>
-#include <thread>
-#include <chrono>
+#include "../src/clock.h"
 #include "../src/host_stubs.h"
 extern void setup();
 extern void loop();
@@ -10,10 +9,11 @@ extern HostSerial2 Serial2;
 extern HostBT SerialBT;
 
 int main() {
+    Clock::useVirtual();
     setup();
     // Push only a Note OFF message (0x80, note=64, vel=0)
     Serial2.push(std::vector<uint8_t>{0x80, 64, 0});
-    for (int i = 0; i < 10; ++i) { loop(); std::this_thread::sleep_for(std::chrono::milliseconds(5)); }
+    for (int i = 0; i < 10; ++i) { loop(); Clock::advanceMs(5); }
     auto caps = SerialBT.getCaptured();
     if (!caps.empty()) {
         std::cerr << "Expected no BT packets, but captured=" << caps.size() << "\n";
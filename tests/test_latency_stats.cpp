@@ -0,0 +1,40 @@
+// Test the input-to-pixel latency report: bucketed percentiles, the maximum,
+// windowing, and overflow past the last bucket
+#include <cassert>
+#include <iostream>
+#include "../src/latency_stats.h"
+
+int main() {
+    LatencyStats stats;
+    LatencyStats::Report r{};
+    // The first take() only opens the window
+    assert(!stats.take(0, 1000000, r));
+
+    // 98 fast notes, one at 2.2 ms and one stuck behind a 40 ms stall
+    for (int i = 0; i < 98; ++i) stats.add(120 + i % 3);
+    stats.add(2210);
+    stats.add(40000);
+    assert(stats.count() == 100);
+    assert(!stats.take(500000, 1000000, r));   // window not over yet
+    assert(stats.take(1000000, 1000000, r));
+    assert(r.count == 100);
+    assert(r.p50Us == 150);                     // 120-122 us land in [100, 150)
+    assert(r.p99Us == 2250);                    // the 99th sample is the 2.2 ms one
+    assert(r.maxUs == 40000);
+
+    // The next window starts from scratch; a window with no notes is not reported
+    assert(stats.count() == 0);
+    assert(!stats.take(3000000, 1000000, r));
+    stats.add(0);
+    assert(stats.take(3000001, 1000000, r));
+    assert(r.count == 1 && r.p50Us == 0 && r.p99Us == 0 && r.maxUs == 0);   // never above the maximum
+
+    // Everything in the overflow bucket reports the true maximum
+    stats.add(12000);
+    stats.add(15000);
+    assert(stats.take(5000000, 1000000, r));
+    assert(r.p50Us == 15000 && r.p99Us == 15000 && r.maxUs == 15000);
+
+    std::cout << "Test latency_stats passed\n";
+    return 0;
+}
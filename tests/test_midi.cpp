@@ -1,10 +1,9 @@
 // Simple unit test for MIDI parsing and BT packet formation using host stubs.
 #include <cassert>
 #include <iostream>
-#include <thread>
-#include <chrono>
 
 // Pull in the application (it will use host stubs when not ARDUINO)
+#include "../src/clock.h"
 #include "../src/host_stubs.h"
 extern void setup();
 extern void loop();
@@ -12,6 +11,7 @@ extern HostSerial2 Serial2;
 extern HostBT SerialBT;
 
 int main() {
+    Clock::useVirtual();
     setup();
     // Simulate: Note on (0x90, note=60, vel=64), then Note off (0x80, note=60, vel=0)
     std::vector<uint8_t> msg = { 0x90, 60, 64, 0x80, 60, 0 };
@@ -20,7 +20,7 @@ int main() {
     // Run the loop a few times to process
     for (int i = 0; i < 20; ++i) {
         loop();
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        Clock::advanceMs(5);
     }
 
     auto captured = SerialBT.getCaptured();
@@ -0,0 +1,96 @@
+// Test the table-driven MIDI 1.0 parser: running status, real-time interleave,
+// SysEx skipping and typed channel messages
+#include <cassert>
+#include <iostream>
+#include <vector>
+#include "../src/teachtiles.h"
+#include "../src/midi_parser.h"
+#include "../src/clock.h"
+#include "../src/host_stubs.h"
+extern void setup();
+extern void loop();
+extern HostSerial2 Serial2;
+extern HostBT SerialBT;
+
+static std::vector<Midi::Message> parse(Midi::Parser& p, const std::vector<uint8_t>& bytes) {
+    std::vector<Midi::Message> out;
+    p.feed(bytes.data(), bytes.size(), [&](const Midi::Message& m) { out.push_back(m); });
+    return out;
+}
+
+int main() {
+    using namespace Midi;
+    Parser p;
+
+    // Running status: one status byte, three notes; NoteOn velocity 0 is a NoteOff
+    auto m = parse(p, {0x91, 60, 100, 64, 90, 60, 0});
+    assert(m.size() == 3);
+    assert(m[0].type == MSG_NOTE_ON && m[0].channel == 1 && m[0].data1 == 60 && m[0].data2 == 100);
+    assert(m[1].type == MSG_NOTE_ON && m[1].data1 == 64);
+    assert(m[2].type == MSG_NOTE_OFF && m[2].data1 == 60);
+    assert(p.runningStatus() == 0x91);
+
+    // Real-time bytes between any two bytes are reported without disturbing the message
+    p.reset();
+    m = parse(p, {0x90, 0xF8, 62, 0xFE, 80, 0xF8});
+    assert(m.size() == 4);
+    assert(m[0].type == MSG_REALTIME && m[0].status == 0xF8);
+    assert(m[1].type == MSG_REALTIME && m[1].status == 0xFE);
+    assert(m[2].type == MSG_NOTE_ON && m[2].data1 == 62 && m[2].data2 == 80);
+    assert(m[3].status == 0xF8);
+
+    // SysEx payload is skipped, running status is cancelled, the next message parses
+    Parser s;
+    m = parse(s, {0x90, 60, 100, 0xF0, 0x7E, 0x00, 0x06, 0x01, 0xF7, 61, 100, 0x80, 61, 0});
+    assert(m.size() == 2);
+    assert(m[0].data1 == 60);
+    assert(m[1].type == MSG_NOTE_OFF && m[1].data1 == 61);
+    assert(s.sysexBytesSkipped() == 4);
+    // A status byte terminates an unterminated SysEx; byte-at-a-time push agrees with feed()
+    Parser b;
+    Message one;
+    int count = 0;
+    for (uint8_t x : std::vector<uint8_t>{0xF0, 1, 2, 3, 0x92, 70, 110}) if (b.push(x, one)) ++count;
+    assert(count == 1 && one.type == MSG_NOTE_ON && one.channel == 2 && one.data1 == 70);
+    assert(b.sysexBytesSkipped() == 3);
+
+    // Typed channel messages, including one-data-byte running status
+    p.reset();
+    m = parse(p, {0xB0, 64, 127, 0xE3, 0x00, 0x40, 0xE3, 0x7F, 0x7F, 0xA0, 60, 33, 0xD5, 20, 21, 0xC2, 5});
+    assert(m.size() == 7);
+    assert(m[0].type == MSG_CONTROL_CHANGE && m[0].data1 == 64 && m[0].data2 == 127);
+    assert(m[1].type == MSG_PITCH_BEND && m[1].channel == 3 && m[1].pitchBend() == 0);
+    assert(m[2].pitchBend() == 8191);
+    assert(m[3].type == MSG_POLY_AFTERTOUCH && m[3].data1 == 60 && m[3].data2 == 33);
+    assert(m[4].type == MSG_CHANNEL_AFTERTOUCH && m[4].channel == 5 && m[4].data1 == 20);
+    assert(m[5].type == MSG_CHANNEL_AFTERTOUCH && m[5].data1 == 21);
+    assert(m[6].type == MSG_PROGRAM_CHANGE && m[6].channel == 2 && m[6].data1 == 5);
+
+    // System common messages cancel running status; stray data bytes are dropped
+    p.reset();
+    m = parse(p, {0x90, 60, 100, 0xF3, 4, 61, 100, 0xF6, 62});
+    assert(m.size() == 3);
+    assert(m[1].type == MSG_SYSTEM_COMMON && m[1].status == 0xF3 && m[1].data1 == 4);
+    assert(m[2].type == MSG_SYSTEM_COMMON && m[2].status == 0xF6);
+    assert(p.runningStatus() == 0);
+
+    // A new status in the middle of a message abandons the partial one
+    p.reset();
+    m = parse(p, {0x90, 60, 0x80, 60, 0});
+    assert(m.size() == 1 && m[0].type == MSG_NOTE_OFF);
+
+    // Firmware path: a clock byte mid-message no longer clobbers the note
+    Clock::useVirtual();
+    setup();
+    wireMode = WM_LEGACY_DURATION;
+    Serial2.push(std::vector<uint8_t>{0x90, 0xF8, 60, 0xF8, 100});
+    for (int i = 0; i < 5; ++i) { loop(); Clock::advanceMs(5); }
+    Serial2.push(std::vector<uint8_t>{60, 0xFE, 0});  // running-status NoteOn velocity 0
+    for (int i = 0; i < 5; ++i) { loop(); Clock::advanceMs(5); }
+    auto caps = SerialBT.getCaptured();
+    assert(caps.size() == 1);
+    assert(caps[0].size() == 5 && caps[0][0] == 60);
+
+    std::cout << "Test midi_parser passed\n";
+    return 0;
+}
@@ -0,0 +1,58 @@
+// Test the constexpr note tables against the per-call computations they replace
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include "../src/teachtiles.h"
+#include "../src/note_tables.h"
+
+// Previous Monalith noteToIndex()/xyToIndex() for a 64x64 panel
+static int legacyLedIndex(uint8_t note) {
+    const int W = 64, H = 64;
+    if (note < 21) note = 21;
+    if (note > 108) note = 108;
+    int x = ((note - 21) * W) / 88;
+    int y = H / 2;
+    return (y % 2 == 0) ? y * W + x : y * W + (W - 1 - x);
+}
+
+// Previous midi_note_display getMidiNoteYPosition()
+static int legacyStaffY(uint8_t note) {
+    static const int whiteKey[12] = {0, 0, 1, 1, 2, 3, 3, 4, 4, 5, 5, 6};
+    int steps = ((note / 12) - 5) * 7 + whiteKey[note % 12];
+    int y = 31 - steps * 2;
+    if (y < 3) y = 3;
+    if (y > 60) y = 60;
+    return y;
+}
+
+int main() {
+    using namespace NoteTables;
+    static const char* names[] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+    using Staff = NoteTables::Staff<31, 2, 3, 60>;
+    for (int n = 0; n < 128; ++n) {
+        char expect[8];
+        std::snprintf(expect, sizeof(expect), "%s%d", names[n % 12], n / 12 - 1);
+        assert(std::strcmp(NAME[(uint8_t)n].s, expect) == 0);
+        assert(OCTAVE[(uint8_t)n] == n / 12 - 1);
+        assert(PITCH_CLASS[(uint8_t)n] == n % 12);
+        assert(HUE[(uint8_t)n] == (uint8_t)((n % 12) * (256 / 12)));
+        assert((Panel<64, 64>::LED_INDEX[(uint8_t)n] == legacyLedIndex((uint8_t)n)));
+        assert(Staff::Y[(uint8_t)n] == legacyStaffY((uint8_t)n));
+        bool black = (n % 12 == 1 || n % 12 == 3 || n % 12 == 6 || n % 12 == 8 || n % 12 == 10);
+        assert((ACCIDENTAL[(uint8_t)n] != ACC_NATURAL) == black);
+    }
+    assert(ACCIDENTAL[61] == ACC_SHARP && ACCIDENTAL[63] == ACC_FLAT && ACCIDENTAL[66] == ACC_SHARP);
+    assert(WHITE_KEY[60] == 35 && WHITE_KEY[61] == 35 && WHITE_KEY[62] == 36 && WHITE_KEY[72] == 42);
+    // Geometry is a template parameter: a 32-wide panel spreads the keyboard over 32 columns
+    using Small = Panel<32, 16>;
+    assert(Small::LED_INDEX[21] == 8 * 32 && Small::LED_INDEX[108] == 8 * 32 + 31);
+
+    // midiNoteToName() now points into the table: two results can be held at once
+    const char* a = midiNoteToName(60);
+    const char* b = midiNoteToName(61);
+    assert(std::strcmp(a, "C4") == 0 && std::strcmp(b, "C#4") == 0);
+
+    std::cout << "Test note_tables passed\n";
+    return 0;
+}
@@ -1,8 +1,7 @@
 // Test overlapping note-ons: two notes on, then off, ensure two packets captured
 #include <cassert>
 #include <iostream>
-#include <thread>
-#include <chrono>
+#include "../src/clock.h"
 #include "../src/host_stubs.h"
 extern void setup();
 extern void loop();
@@ -10,13 +9,14 @@ extern HostSerial2 Serial2;
 extern HostBT SerialBT;
 
 int main(){
+    Clock::useVirtual();
     setup();
     Serial2.push(std::vector<uint8_t>{0x90,60,100, 0x90,61,100}); // two note-ons
     // process
-    for(int i=0;i<10;i++){ loop(); std::this_thread::sleep_for(std::chrono::milliseconds(5)); }
+    for(int i=0;i<10;i++){ loop(); Clock::advanceMs(5); }
     // now send offs
     Serial2.push(std::vector<uint8_t>{0x80,60,0, 0x80,61,0});
-    for(int i=0;i<20;i++){ loop(); std::this_thread::sleep_for(std::chrono::milliseconds(5)); }
+    for(int i=0;i<20;i++){ loop(); Clock::advanceMs(5); }
     auto caps = SerialBT.getCaptured();
     std::cout<<"captured="<<caps.size()<<"\n";
     assert(caps.size()>=2);
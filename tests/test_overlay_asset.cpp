@@ -0,0 +1,120 @@
+// Test the packed overlay formats: every format round-trips through
+// scripts/overlay_encode.h and Overlay::decode(), palette limits and short
+// or corrupt data are rejected, and the shipped overlays decode to the
+// two-colour images Monalith and midi_note_display show
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "../src/clock.h"
+#include "monalith.h"
+#include "../scripts/overlay_encode.h"
+#include "../midi_note_display/teachtiles_overlay.h"
+
+extern const OverlayAsset example_overlay;   // example_bitmap.c
+
+static std::vector<uint16_t> decoded(const OverlayAsset& a, int stride, uint16_t fill = 0xDEAD) {
+    std::vector<uint16_t> out((size_t)stride * a.height, fill);
+    assert(Overlay::decode(a, out.data(), stride));
+    return out;
+}
+
+// minPacked: the fewest-bits packed format the image's palette fits
+static void roundTrip(const std::vector<uint16_t>& px, int w, int h, int minPacked) {
+    for (int f = OVERLAY_RGB565; f <= OVERLAY_RLE; ++f) {
+        EncodedOverlay e;
+        bool fits = encodeOverlay(px.data(), w, h, f, e);
+        if (f != OVERLAY_RGB565 && f < minPacked) { assert(!fits); continue; }
+        assert(fits);
+        OverlayAsset a = e.asset();
+        assert(Overlay::storageBytes(a) == e.bytes());
+        std::vector<uint16_t> out = decoded(a, w);
+        assert(out == px);
+        // a wider stride leaves the padding columns alone
+        out = decoded(a, w + 3);
+        for (int y = 0; y < h; ++y) {
+            assert(memcmp(&out[(size_t)y * (w + 3)], &px[(size_t)y * w], w * sizeof(uint16_t)) == 0);
+            for (int x = w; x < w + 3; ++x) assert(out[(size_t)y * (w + 3) + x] == 0xDEAD);
+        }
+    }
+}
+
+int main() {
+    // Sizes of the packed formats
+    static_assert(Overlay::packedRowBytes(OVERLAY_MASK1, 64) == 8, "mask row");
+    static_assert(Overlay::packedRowBytes(OVERLAY_PAL2, 13) == 4, "pal2 row is padded");
+    static_assert(Overlay::packedRowBytes(OVERLAY_PAL4, 64) == 32, "pal4 row");
+    static_assert(Overlay::packedRowBytes(OVERLAY_RLE, 64) == 0, "rle is not row packed");
+
+    // Two colours with an odd width fit every format
+    const int w = 13, h = 7;
+    std::vector<uint16_t> two((size_t)w * h);
+    for (int i = 0; i < w * h; ++i) two[i] = (i % 5 == 0 || i > 60) ? 0xFFFF : 0x0000;
+    roundTrip(two, w, h, OVERLAY_MASK1);
+
+    // Four and sixteen colours need pal2 / pal4
+    std::vector<uint16_t> four(two), sixteen(two);
+    for (int i = 0; i < w * h; ++i) four[i] = (uint16_t)(0x0841 * (i % 4));
+    for (int i = 0; i < w * h; ++i) sixteen[i] = (uint16_t)(0x1000 + (i * 7) % 16);
+    roundTrip(four, w, h, OVERLAY_PAL2);
+    roundTrip(sixteen, w, h, OVERLAY_PAL4);
+
+    // More than 16 colours only fit RGB565
+    std::vector<uint16_t> many(two);
+    for (int i = 0; i < w * h; ++i) many[i] = (uint16_t)i;
+    EncodedOverlay e;
+    assert(!encodeOverlay(many.data(), w, h, OVERLAY_RLE, e));
+    assert(!encodeOverlay(many.data(), w, h, OVERLAY_PAL4, e));
+    assert(encodeSmallestOverlay(many.data(), w, h).format == OVERLAY_RGB565);
+
+    // RLE runs span rows and use the two-byte form from 16 pixels up to 271
+    std::vector<uint16_t> runs(64 * 8, 0x001F);
+    for (int i = 300; i < 317; ++i) runs[i] = 0xF800;
+    assert(encodeOverlay(runs.data(), 64, 8, OVERLAY_RLE, e));
+    assert(e.data.size() == 2 + 2 + 2 + 2);   // 271 + 29 blue, 17 red, 195 blue
+    assert(decoded(e.asset(), 64) == runs);
+    assert(encodeSmallestOverlay(runs.data(), 64, 8).format == OVERLAY_RLE);
+
+    // Truncated data and indices outside the palette are rejected
+    std::vector<uint16_t> scratch(64 * 64);
+    OverlayAsset bad = e.asset();
+    bad.dataBytes -= 1;
+    assert(!Overlay::decode(bad, scratch.data(), 64));
+    assert(encodeOverlay(two.data(), w, h, OVERLAY_MASK1, e));
+    bad = e.asset();
+    bad.dataBytes -= 1;
+    assert(!Overlay::decode(bad, scratch.data(), w));
+    assert(encodeOverlay(four.data(), w, h, OVERLAY_PAL2, e));
+    bad = e.asset();
+    bad.paletteSize = 3;
+    assert(!Overlay::decode(bad, scratch.data(), w));
+    bad.format = 9;
+    assert(!Overlay::decode(bad, scratch.data(), w));
+
+    // The shipped overlays: two colours, 64x64, a few hundred bytes
+    for (const OverlayAsset* a : {&teachtiles_overlay, &example_overlay}) {
+        assert(a->width == 64 && a->height == 64 && a->paletteSize == 2);
+        assert(Overlay::storageBytes(*a) < 512);
+        std::vector<uint16_t> px = decoded(*a, 64);
+        size_t black = 0, white = 0;
+        for (uint16_t c : px) { black += c == 0x0000; white += c == 0xFFFF; }
+        assert(black + white == px.size() && black > 0 && white > 0);
+    }
+    // midi_note_display's copy is inverted: white staff lines on black
+    std::vector<uint16_t> staff = decoded(teachtiles_overlay, 64);
+    assert(staff[0] == 0x0000);
+
+    // Monalith decodes straight into its background layer
+    Clock::useVirtual(0);
+    Monalith::init();
+    Monalith::clearStaticBitmap();
+    assert(Monalith::showStaticOverlay(example_overlay));
+    assert(memcmp(Monalith::hostFramebuffer(), decoded(example_overlay, 64).data(), 64 * 64 * 2) == 0);
+    OverlayAsset small = example_overlay;
+    small.width = 32;
+    assert(!Monalith::showStaticOverlay(small));
+    for (int i = 0; i < 64 * 64; ++i) assert(Monalith::hostFramebuffer()[i] == 0);
+
+    std::cout << "Test overlay_asset passed\n";
+    return 0;
+}
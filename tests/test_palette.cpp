@@ -0,0 +1,51 @@
+// Test Monalith's constexpr note palette against the per-pixel conversion it replaces
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include "palette.h"
+
+// Previous per-pixel path: integer HSV -> RGB, then RGB565 pack
+static uint16_t legacy565(uint8_t H, uint8_t V) {
+    const uint8_t S = 200;
+    uint8_t r, g, b;
+    uint8_t region = H / 43;
+    uint8_t remainder = (H - (region * 43)) * 6;
+    uint8_t p = (V * (255 - S)) >> 8;
+    uint8_t q = (V * (255 - ((S * remainder) >> 8))) >> 8;
+    uint8_t t = (V * (255 - ((S * (255 - remainder)) >> 8))) >> 8;
+    switch (region) {
+        case 0: r = V; g = t; b = p; break;
+        case 1: r = q; g = V; b = p; break;
+        case 2: r = p; g = V; b = t; break;
+        case 3: r = p; g = q; b = V; break;
+        case 4: r = t; g = p; b = V; break;
+        default: r = V; g = p; b = q; break;
+    }
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+int main() {
+    using namespace Monalith::Palette;
+    // The constexpr gamma curve matches the floating-point one to within rounding
+    for (int i = 0; i < 256; ++i) {
+        int expect = (int)(std::pow(i / 255.0, MONALITH_GAMMA) * 255.0 + 0.5);
+        assert(std::abs((int)GAMMA.v[i] - expect) <= 1);
+        if (i) assert(GAMMA.v[i] >= GAMMA.v[i - 1]);
+    }
+    for (int n = 0; n < 128; ++n) {
+        uint8_t r = row((uint8_t)n);
+        assert(r == n % 12);
+        for (int l = 0; l < LEVELS; ++l) {
+            Rgb c = hsv(NoteTables::HUE[(uint8_t)n], SATURATION, (uint8_t)l);
+            assert(RGB565[r][l] == pack565(corrected(c)));
+            // With the gamma table taken out, the entry is exactly the old conversion
+            Rgb raw = hsv(NoteTables::HUE[(uint8_t)n], SATURATION, (uint8_t)l);
+            assert(pack565(raw) == legacy565(NoteTables::HUE[(uint8_t)n], (uint8_t)l));
+        }
+    }
+    assert(RGB565[0][255] != 0 && RGB565[5][0] == 0);
+
+    std::cout << "Test palette passed\n";
+    return 0;
+}
@@ -0,0 +1,82 @@
+// Test the non-blocking boot path: showStaticBitmapFast() presents at once,
+// the panel self-test is advanced by tick() without blocking, notes shown
+// meanwhile reappear when it ends, and the first note's time is recorded
+#include <cassert>
+#include <iostream>
+#include "../src/clock.h"
+#include "monalith.h"
+
+static bool allPixels(const uint16_t* fb, uint16_t c) {
+    for (int i = 0; i < 64 * 64; ++i) if (fb[i] != c) return false;
+    return true;
+}
+
+static size_t pixelsOf(const uint16_t* fb, uint16_t c) {
+    size_t n = 0;
+    for (int i = 0; i < 64 * 64; ++i) if (fb[i] == c) ++n;
+    return n;
+}
+
+int main() {
+    Clock::useVirtual(1000000);
+    Monalith::init();
+    assert(Monalith::firstNoteMs() == 0);
+
+    // The bitmap is on the panel as soon as the call returns, with no time passing
+    static uint16_t bitmap[64 * 64];
+    for (int i = 0; i < 64 * 64; ++i) bitmap[i] = 0x0841;
+    Monalith::showStaticBitmapFast(bitmap);
+    assert(allPixels(Monalith::hostFramebuffer(), 0x0841));
+    Monalith::showStaticBitmap(bitmap);   // host builds default to no boot self-test
+    assert(!Monalith::selfTestActive());
+    assert(Clock::nowMs() == 1000);
+
+    // The self-test starts with a white hold and returns immediately
+    Monalith::startSelfTest();
+    assert(Monalith::selfTestActive());
+    assert(allPixels(Monalith::hostFramebuffer(), 0xFFFF));
+    // A note arriving meanwhile is recorded but stays hidden behind the test
+    Monalith::showNote(60, Monalith::DURATION_HELD, 100);
+    assert(Monalith::firstNoteMs() == 0);
+    Clock::advanceMs(9990);
+    Monalith::tick();
+    assert(allPixels(Monalith::hostFramebuffer(), 0xFFFF));
+
+    // Red, green, blue, white fills, 3 s each
+    const uint16_t colours[] = {0xF800, 0x07E0, 0x001F, 0xFFFF};
+    for (uint16_t c : colours) {
+        Clock::advanceMs(10);
+        Monalith::tick();
+        assert(allPixels(Monalith::hostFramebuffer(), c));
+        Clock::advanceMs(2990);
+        Monalith::tick();
+        assert(allPixels(Monalith::hostFramebuffer(), c));
+    }
+    // Row sweep: one red row at a time, 200 ms each
+    for (int y = 0; y < 64; ++y) {
+        Clock::advanceMs(y == 0 ? 10 : 200);
+        Monalith::tick();
+        const uint16_t* fb = Monalith::hostFramebuffer();
+        assert(pixelsOf(fb, 0xF800) == 64);
+        for (int x = 0; x < 64; ++x) assert(fb[y * 64 + x] == 0xF800);
+    }
+    assert(Monalith::selfTestActive());
+
+    // After the last row the bitmap and the held note come back
+    Clock::advanceMs(200);
+    Monalith::tick();
+    assert(!Monalith::selfTestActive());
+    const uint16_t* fb = Monalith::hostFramebuffer();
+    assert(pixelsOf(fb, 0x0841) == 64 * 64 - 5);
+    // The first note counts as shown with the frame that uncovered it
+    uint32_t shownMs = Clock::nowMs();
+    assert(shownMs > 1000 && Monalith::firstNoteMs() == shownMs);
+    // Later notes do not move the first-note time
+    Monalith::showNote(64, 50, 100);
+    Clock::advanceMs(100);
+    Monalith::tick();
+    assert(Monalith::firstNoteMs() == shownMs);
+
+    std::cout << "Test self_test passed\n";
+    return 0;
+}
@@ -0,0 +1,73 @@
+// Test the incremental staff renderer used by midi_note_display: a new note
+// writes only its sprite's pixels, erasing restores the inverted overlay
+// under it, and a full repaint matches drawing everything from scratch
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include "../src/staff_renderer.h"
+#include "../midi_note_display/teachtiles_overlay.h"
+
+using namespace StaffRender;
+
+struct FakePanel {
+    uint16_t px[PIXELS] = {};
+    uint32_t writes = 0;
+    void drawPixel(int16_t x, int16_t y, uint16_t c) {
+        assert(x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT);
+        px[y * WIDTH + x] = c;
+        ++writes;
+    }
+};
+
+static uint16_t background[PIXELS];
+
+int main() {
+    assert(Overlay::decode(teachtiles_overlay, background, WIDTH));
+    assert(invertedRgb565(0x00FFFFFF) == 0 && invertedRgb565(0x00000000) == 0xFFFF);
+    assert(rgb565(255, 0, 0) == 0xF800 && rgb565(0, 255, 0) == 0x07E0 && rgb565(0, 0, 255) == 0x001F);
+
+    static FakePanel panel;
+    Renderer<FakePanel> r;
+    r.begin(&panel, background);
+    r.redrawAll(nullptr, 0);
+    assert(r.fullRedraws() == 1 && panel.writes == PIXELS);
+    assert(memcmp(panel.px, background, sizeof(background)) == 0);
+
+    // Each new note writes only its own pixels
+    Sprite natural{18, 31, 0x1234, SHAPE_NATURAL, SHIFT_NONE};
+    Sprite sharp{22, 20, 0x2345, SHAPE_SHARP, SHIFT_UP};
+    Sprite flat{26, 52, 0x3456, SHAPE_FLAT, SHIFT_DOWN};
+    uint32_t before = r.pixelsWritten();
+    r.draw(natural);
+    assert(r.pixelsWritten() - before == 9);
+    r.draw(sharp);
+    assert(r.pixelsWritten() - before == 9 + 5 + 4);
+    r.draw(flat);
+    assert(r.pixelsWritten() - before == 9 + 5 + 4 + 5 + 4);
+    assert(panel.px[31 * WIDTH + 18] == 0x1234 && panel.px[30 * WIDTH + 17] == 0x1234);
+    assert(panel.px[16 * WIDTH + 22] == 0x2345);                      // up arrow tip
+    assert(panel.px[19 * WIDTH + 21] == background[19 * WIDTH + 21]); // sharp leaves its corners alone
+    assert(panel.px[56 * WIDTH + 26] == 0x3456);                      // down arrow tip
+
+    // The incremental frame equals a full repaint of the same notes
+    static FakePanel full;
+    Renderer<FakePanel> ref;
+    ref.begin(&full, background);
+    Sprite all[] = {natural, sharp, flat};
+    ref.redrawAll(all, 3);
+    assert(memcmp(panel.px, full.px, sizeof(full.px)) == 0);
+
+    // Erasing puts back exactly the overlay pixels under the sprite
+    r.erase(sharp);
+    ref.redrawAll(all, 1);
+    ref.draw(flat);
+    assert(memcmp(panel.px, full.px, sizeof(full.px)) == 0);
+
+    // Sprites at the panel edge are clipped
+    before = panel.writes;
+    r.draw(Sprite{0, 63, 0xFFFF, SHAPE_NATURAL, SHIFT_DOWN});
+    assert(panel.writes - before == 4);
+
+    std::cout << "Test staff_renderer passed\n";
+    return 0;
+}
@@ -0,0 +1,111 @@
+// Test the scrolling staff used by midi_note_display: the sixth note no
+// longer clears the staff but slides the notes left one column per step,
+// each step only moves note pixels, notes leaving the staff are dropped
+// from the ring, and the clear-when-full mode still works
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include "../src/staff_renderer.h"
+#include "../midi_note_display/teachtiles_overlay.h"
+
+using namespace StaffRender;
+
+struct FakePanel {
+    uint16_t px[PIXELS] = {};
+    void drawPixel(int16_t x, int16_t y, uint16_t c) {
+        assert(x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT);
+        px[y * WIDTH + x] = c;
+    }
+};
+
+// midi_note_display's staff: five notes from x 18 in the 22 columns before the bar line
+constexpr StaffLayout LAYOUT{18, 4, 5, 17, 18 + 22};
+using Staff = ScrollingStaff<FakePanel, 8>;
+
+static uint16_t background[PIXELS];
+
+// The panel must equal the overlay plus every ring note drawn from scratch
+static void assertMatchesScratch(const FakePanel& panel, const Staff& staff) {
+    static FakePanel scratch;
+    Renderer<FakePanel> ref;
+    ref.begin(&scratch, background);
+    ref.setClip(LAYOUT.clipLeft, LAYOUT.clipRight);
+    ref.redrawAll(nullptr, 0);
+    for (int i = 0; i < staff.size(); ++i) ref.draw(staff.at(i).sprite, -staff.offset());
+    assert(memcmp(panel.px, scratch.px, sizeof(scratch.px)) == 0);
+}
+
+static Sprite note(int y, uint8_t shape = SHAPE_NATURAL, uint8_t shift = SHIFT_NONE) {
+    return Sprite{0, (int16_t)y, (uint16_t)(0x1000 + y), shape, shift};
+}
+
+int main() {
+    assert(Overlay::decode(teachtiles_overlay, background, WIDTH));
+
+    static FakePanel panel;
+    Renderer<FakePanel> r;
+    r.begin(&panel, background);
+    Staff staff;
+    staff.begin(&r, LAYOUT, 30, true);
+    staff.redraw();
+    assert(r.fullRedraws() == 1);
+
+    // Five notes fill the staff without scrolling
+    const int ys[] = {31, 23, 44, 15, 52, 27, 36};
+    for (int i = 0; i < 5; ++i) {
+        assert(!staff.add(note(ys[i], (uint8_t)(i % 3), (uint8_t)(i % 3)), 100u * i));
+        assert(staff.screenX(staff.newest()) == 18 + 4 * i);
+    }
+    assert(!staff.tick(1000) && !staff.scrolling());
+    assertMatchesScratch(panel, staff);
+
+    // The sixth waits just right of them, then everything slides 4 columns
+    assert(!staff.add(note(ys[5]), 500));
+    assert(staff.size() == 6 && staff.screenX(staff.newest()) == 38 && staff.scrolling());
+    assertMatchesScratch(panel, staff);
+    assert(staff.msUntilNextStep(500) == 30 && staff.msUntilNextStep(529) == 1);
+    assert(!staff.tick(529));
+    uint32_t before = r.pixelsWritten();
+    assert(staff.tick(530) && staff.offset() == 1);
+    assert(r.pixelsWritten() - before < PIXELS / 16);   // note pixels only
+    assertMatchesScratch(panel, staff);
+    assert(staff.msUntilNextStep(530) == 30 && staff.msUntilNextStep(575) == 0);
+    assert(staff.tick(560) && staff.offset() == 2);
+    assertMatchesScratch(panel, staff);                   // oldest note half off the staff
+    assert(staff.tick(700) && staff.offset() == 4 && !staff.scrolling());
+    assert(staff.size() == 5 && staff.at(0).timeMs == 100);  // the first note left the ring
+    assert(staff.msUntilNextStep(700) == Staff::NO_STEP);   // nothing to wake up for
+    assert(staff.screenX(staff.at(0)) == 18 && staff.screenX(staff.newest()) == 34);
+    assertMatchesScratch(panel, staff);
+    assert(r.fullRedraws() == 1);
+
+    // A note arriving mid-scroll finishes the previous scroll first
+    assert(!staff.add(note(ys[6]), 800));
+    assert(staff.tick(830) && staff.offset() == 5);
+    assert(!staff.add(note(ys[0]), 840));
+    assert(staff.offset() == 8 && staff.screenX(staff.newest()) == 38);
+    assert(staff.tick(1000) && staff.offset() == 12);
+    assertMatchesScratch(panel, staff);
+
+    // Long sessions stay exact (sprite columns are rebased) and never repaint
+    staff.begin(&r, LAYOUT, 0, true);
+    staff.clear();
+    uint32_t redraws = r.fullRedraws();
+    for (uint32_t i = 0; i < 5000; ++i) staff.add(note(ys[i % 7], (uint8_t)(i % 3), (uint8_t)(i % 3)), i);
+    assert(staff.size() == 5 && staff.screenX(staff.newest()) == 34 && !staff.scrolling());
+    assert(r.fullRedraws() == redraws);
+    assertMatchesScratch(panel, staff);
+
+    // Clear mode: the sixth note wipes the staff and starts again at firstX
+    staff.begin(&r, LAYOUT, 30, false);
+    staff.clear();
+    for (int i = 0; i < 5; ++i) assert(!staff.add(note(ys[i]), i));
+    redraws = r.fullRedraws();
+    assert(staff.add(note(ys[5]), 5));
+    assert(r.fullRedraws() == redraws + 1 && staff.size() == 1);
+    assert(staff.screenX(staff.newest()) == 18 && !staff.tick(1000));
+    assertMatchesScratch(panel, staff);
+
+    std::cout << "Test staff_scroll passed\n";
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Test streaming mode: NoteOn is sent as soon as it is parsed, before the key is released
+#include <cassert>
+#include <iostream>
+#include "../src/teachtiles.h"
+#include "../src/wire_protocol.h"
+#include "../src/clock.h"
+#include "../src/host_stubs.h"
+extern void setup();
+extern void loop();
+extern HostSerial2 Serial2;
+extern HostBT SerialBT;
+
+static size_t decode(const std::vector<uint8_t>& pkt, WireProtocol::FrameHeader& h, WireProtocol::Event* ev) {
+    return WireProtocol::decodePacket(pkt.data(), pkt.size(), h, ev, WireProtocol::MAX_EVENTS);
+}
+
+int main() {
+    Clock::useVirtual();
+    setup();
+    wireMode = WM_STREAM_EVENTS;
+    WireProtocol::FrameHeader h;
+    WireProtocol::Event ev[WireProtocol::MAX_EVENTS];
+
+    Serial2.push(std::vector<uint8_t>{0x90, 60, 100});
+    for (int i = 0; i < 5; ++i) { loop(); Clock::advanceMs(5); }
+    auto caps = SerialBT.getCaptured();
+    // NoteOn must be on the wire while the key is still held
+    assert(caps.size() == 1);
+    assert(decode(caps[0], h, ev) == 1);
+    assert(h.version == WireProtocol::VERSION);
+    assert(ev[0].type == WireProtocol::EV_NOTE_ON && ev[0].note == 60 && ev[0].velocity == 100);
+    uint16_t firstSeq = h.seq;
+
+    Serial2.push(std::vector<uint8_t>{0x80, 60, 40});
+    for (int i = 0; i < 5; ++i) { loop(); Clock::advanceMs(5); }
+    caps = SerialBT.getCaptured();
+    assert(caps.size() == 2);
+    assert(decode(caps[1], h, ev) == 1);
+    assert(ev[0].type == WireProtocol::EV_NOTE_OFF && ev[0].note == 60 && ev[0].velocity == 40);
+    assert(ev[0].duration > 0);
+    assert(h.seq == (uint16_t)(firstSeq + 1));
+
+    // An OFF without a prior ON is still ignored in streaming mode
+    Serial2.push(std::vector<uint8_t>{0x80, 61, 0});
+    for (int i = 0; i < 5; ++i) { loop(); Clock::advanceMs(5); }
+    assert(SerialBT.getCaptured().size() == 2);
+
+    // A chord arriving within the coalescing window goes out as one frame
+    Serial2.push(std::vector<uint8_t>{0x90, 60, 90, 0x90, 64, 91, 0x90, 67, 92});
+    for (int i = 0; i < 5; ++i) { loop(); Clock::advanceMs(5); }
+    caps = SerialBT.getCaptured();
+    assert(caps.size() == 3);
+    assert(decode(caps[2], h, ev) == 3);
+    assert(ev[0].note == 60 && ev[1].note == 64 && ev[2].note == 67);
+
+    // Events carry the MIDI arrival time, not the time loop() got to them
+    uint32_t arrivedMs = Clock::nowMs();
+    for (uint8_t b : {0x90, 72, 80}) processMidiByte(b, (uint64_t)arrivedMs * 1000);
+    Clock::advanceMs(40);
+    for (int i = 0; i < 5; ++i) { loop(); Clock::advanceMs(5); }
+    caps = SerialBT.getCaptured();
+    assert(caps.size() == 4);
+    assert(decode(caps[3], h, ev) == 1);
+    assert(ev[0].note == 72 && ev[0].time_ms == arrivedMs);
+    std::cout << "Test stream_events passed\n";
+    return 0;
+}
@@ -1,4 +1,20 @@
-#include "src/teachtiles.h"
+// Test the host transport definition: TM_ESPNOW falls back to the SerialBT capture
+// and the default wire mode is the legacy note+duration packet.
+#include <cassert>
+#include <iostream>
+#include "../src/teachtiles.h"
+#include "../src/host_stubs.h"
+extern HostBT SerialBT;
 
-// Provide a transport definition for host unit tests.
-TransportMode transport = TM_ESPNOW;
+int main() {
+    assert(transport == TM_ESPNOW);
+    assert(wireMode == WM_LEGACY_DURATION);
+    SerialBT.clear();
+    sendNoteData(64, 0x01020304);
+    auto caps = SerialBT.getCaptured();
+    assert(caps.size() == 1);
+    auto p = caps.front();
+    assert(p[0] == 64 && p[1] == 0x01 && p[2] == 0x02 && p[3] == 0x03 && p[4] == 0x04);
+    std::cout << "Test transport_def passed\n";
+    return 0;
+}
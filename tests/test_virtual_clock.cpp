@@ -0,0 +1,66 @@
+// Test a 10-minute simulated practice session on the virtual clock: it must
+// finish in well under a second of wall time with every duration exact, and
+// survive the 32-bit millisecond wraparound.
+#include <cassert>
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../src/clock.h"
+#include "../src/host_stubs.h"
+extern void setup();
+extern void loop();
+extern HostSerial2 Serial2;
+extern HostBT SerialBT;
+
+int main() {
+    // Start 5 s before millis() would wrap (2^32 ms, ~49.7 days of uptime)
+    const uint64_t wrapUs = (uint64_t)0x100000000ull * 1000;
+    Clock::useVirtual(wrapUs - 5000000);
+    setup();
+    // Host Serial output is very chatty; silence it while the session runs
+    std::fflush(stdout);
+    int savedStdout = dup(1);
+    int devNull = open("/dev/null", O_WRONLY);
+    dup2(devNull, 1);
+
+    auto wallStart = std::chrono::steady_clock::now();
+    const uint64_t sessionMs = 10 * 60 * 1000;
+    const uint32_t stepMs = 2;
+    size_t notes = 0;
+    uint64_t t = 0;
+    // A note every 250 ms, held for 40..236 ms depending on the note
+    while (t < sessionMs) {
+        uint8_t note = (uint8_t)(48 + (notes % 24));
+        uint32_t hold = 40 + (notes % 50) * 4;
+        Serial2.push(std::vector<uint8_t>{0x90, note, 100});
+        for (uint32_t e = 0; e < hold; e += stepMs) { loop(); Clock::advanceMs(stepMs); }
+        Serial2.push(std::vector<uint8_t>{0x80, note, 0});
+        for (uint32_t e = hold; e < 250; e += stepMs) { loop(); Clock::advanceMs(stepMs); }
+        t += 250;
+        ++notes;
+    }
+    loop();
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+    std::fflush(stdout);
+    dup2(savedStdout, 1);
+    close(devNull);
+    close(savedStdout);
+
+    const auto& caps = SerialBT.getCaptured();
+    assert(caps.size() == notes);
+    for (size_t i = 0; i < caps.size(); ++i) {
+        const auto& p = caps[i];
+        uint32_t duration = ((uint32_t)p[1] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 8) | p[4];
+        uint32_t hold = 40 + (i % 50) * 4;
+        // the hold loop advances in whole steps, so the expected time is the rounded-up step count
+        uint32_t expect = ((hold + stepMs - 1) / stepMs) * stepMs;
+        assert(p[0] == 48 + (i % 24));
+        assert(duration == expect);
+    }
+    std::cout << "simulated " << sessionMs << " ms (" << notes << " notes) in " << wallMs << " ms wall time\n";
+    assert(wallMs < 10000);
+    std::cout << "Test virtual_clock passed\n";
+    return 0;
+}
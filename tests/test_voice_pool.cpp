@@ -0,0 +1,78 @@
+// Test Monalith's fixed-capacity voice pool: stealing policies, and that
+// showNote()/releaseNote()/tick() never allocate once the visualizer is running
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include "../src/clock.h"
+#include "monalith.h"
+
+// Count every global operator new in the process
+static size_t heapAllocs = 0;
+void* operator new(size_t n) {
+    ++heapAllocs;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+int main() {
+    // Pool mechanics on a small pool
+    Monalith::VoicePool<4> pool;
+    for (int i = 0; i < 4; ++i) {
+        auto v = pool.allocate();
+        pool.start_ms[v] = 100 + i;
+        pool.level[v] = (uint8_t)(200 - i * 50);  // 200, 150, 100, 50
+        pool.note[v] = (uint8_t)(60 + i);
+    }
+    assert(pool.size() == 4 && pool.stolen() == 0);
+    // Oldest: the note started at t=100 is replaced
+    auto v = pool.allocate();
+    assert(pool.stolen() == 1 && pool.size() == 4);
+    pool.start_ms[v] = 200; pool.level[v] = 255; pool.note[v] = 70;
+    bool found60 = false;
+    for (size_t i = 0; i < pool.size(); ++i) found60 |= pool.note[pool.at(i)] == 60;
+    assert(!found60);
+    // Quietest: the note at level 50 (note 63) is replaced
+    pool.setPolicy(Monalith::VoiceSteal::Quietest);
+    v = pool.allocate();
+    pool.note[v] = 71; pool.level[v] = 255;
+    bool found63 = false;
+    for (size_t i = 0; i < pool.size(); ++i) found63 |= pool.note[pool.at(i)] == 63;
+    assert(!found63 && pool.stolen() == 2);
+    // Free while walking backwards keeps the live list consistent
+    for (size_t i = pool.size(); i-- > 0;) pool.release(pool.at(i));
+    assert(pool.size() == 0);
+
+    Clock::useVirtual(1000000);
+    Monalith::init();
+    // Prime stdio so its one-time buffer allocation is not counted
+    std::printf("voice pool test start\n");
+    std::fflush(stdout);
+
+    size_t before = heapAllocs;
+    // A long glissando with held notes and releases, far more notes than voices
+    for (int i = 0; i < 5000; ++i) {
+        uint8_t note = (uint8_t)(21 + i % 88);
+        Monalith::showNote(note, (i % 3) ? 50 : Monalith::DURATION_HELD, (uint8_t)(i % 128));
+        if (i % 3 == 0) Monalith::releaseNote(note);
+        Monalith::tick();
+        Clock::advanceMs(1);
+    }
+    assert(heapAllocs == before);
+    assert(Monalith::activeVoiceCount() <= Monalith::VoicePool<32>::capacity());
+    assert(Monalith::stolenVoiceCount() > 0);
+
+    // Everything expires once the notes are released and trails decay
+    for (int i = 0; i < 200; ++i) { Monalith::tick(); Clock::advanceMs(10); }
+    assert(Monalith::activeVoiceCount() == 0);
+    assert(heapAllocs == before);
+
+    std::cout << "Test voice_pool passed\n";
+    return 0;
+}
@@ -0,0 +1,102 @@
+// Round-trip tests for the v2 wire protocol encoder/decoder shared by all transports
+#include <cassert>
+#include <iostream>
+#include <vector>
+#include "../src/wire_protocol.h"
+
+using namespace WireProtocol;
+
+int main() {
+    // Encode a 10-note chord plus a release and decode it back
+    FrameBatcher tx;
+    tx.seq = 0xFFFF; // exercise sequence wraparound
+    for (uint8_t i = 0; i < 10; ++i) {
+        Event ev{ EV_NOTE_ON, (uint8_t)(48 + i), (uint8_t)(60 + i), 1, 1000u + i, 0 };
+        assert(!tx.add(ev));
+    }
+    assert(tx.add(Event{ EV_NOTE_OFF, 48, 0, 1, 1012, 987654 }) == false);
+    assert(!tx.due(1002, 3));
+    assert(tx.due(1003, 3));
+    uint8_t frame[MAX_FRAME_BYTES];
+    size_t len = tx.flush(frame, sizeof(frame));
+    assert(len == HEADER_BYTES + 11 * EVENT_BYTES);
+    assert(tx.count == 0 && tx.seq == 0);
+
+    FrameHeader h;
+    Event out[MAX_EVENTS];
+    size_t n = decodePacket(frame, len, h, out, MAX_EVENTS);
+    assert(n == 11);
+    assert(h.version == VERSION && h.seq == 0xFFFF && h.time_ms == 1000);
+    for (uint8_t i = 0; i < 10; ++i) {
+        assert(out[i].type == EV_NOTE_ON && out[i].note == 48 + i && out[i].velocity == 60 + i);
+        assert(out[i].source == 1 && out[i].time_ms == 1000u + i);
+    }
+    assert(out[10].type == EV_NOTE_OFF && out[10].duration == 987654 && out[10].time_ms == 1012);
+
+    // Microsecond durations are flagged in the header and converted back to ms
+    Event us{ EV_NOTE_OFF, 60, 0, 0, 5, 1234567 };
+    len = encodeFrame(7, FLAG_DURATION_US, &us, 1, frame, sizeof(frame));
+    assert(decodePacket(frame, len, h, out, MAX_EVENTS) == 1);
+    assert((h.flags & FLAG_DURATION_US) && out[0].duration == 1234567 && durationMs(h, out[0]) == 1235);
+    len = tx.flush(frame, sizeof(frame)); // empty batch encodes nothing
+    assert(len == 0);
+    tx.add(Event{ EV_NOTE_OFF, 48, 0, 1, 1012, 987654 });
+    len = tx.flush(frame, sizeof(frame));
+
+    // Truncated frames are rejected
+    assert(decodePacket(frame, len - 1, h, out, MAX_EVENTS) == 0);
+
+    // A full batch reports that it must be flushed
+    FrameBatcher full;
+    for (size_t i = 0; i + 1 < MAX_EVENTS; ++i) assert(!full.add(Event{ EV_NOTE_ON, 60, 1, 0, 0, 0 }));
+    assert(full.add(Event{ EV_NOTE_ON, 60, 1, 0, 0, 0 }));
+    assert(full.flush(frame, sizeof(frame)) == MAX_FRAME_BYTES);
+
+    // Older formats decode to single events
+    const uint8_t legacy[5] = { 62, 0x00, 0x00, 0x01, 0x2C };
+    assert(decodePacket(legacy, sizeof(legacy), h, out, MAX_EVENTS) == 1);
+    assert(h.version == 0 && out[0].type == EV_NOTE_DURATION && out[0].note == 62 && out[0].duration == 300);
+    const uint8_t v1off[3] = { 0x90, 62, 0 };
+    assert(decodePacket(v1off, sizeof(v1off), h, out, MAX_EVENTS) == 1);
+    assert(h.version == 1 && out[0].type == EV_NOTE_OFF);
+
+    // Stream framing reassembles mixed packets from a byte stream
+    std::vector<uint8_t> stream(legacy, legacy + 5);
+    stream.insert(stream.end(), frame, frame + MAX_FRAME_BYTES);
+    stream.insert(stream.end(), v1off, v1off + 3);
+    StreamFramer framer;
+    std::vector<size_t> lengths;
+    for (uint8_t b : stream) { size_t got = framer.push(b); if (got) lengths.push_back(got); }
+    assert((lengths == std::vector<size_t>{ 5, MAX_FRAME_BYTES, 3 }));
+
+    // Sequence tracking detects loss and reordering
+    SeqTracker rx;
+    assert(rx.accept(10, 0));
+    assert(rx.accept(11, 10));
+    assert(rx.accept(14, 20) && rx.lost == 2);
+    assert(!rx.accept(12, 30) && rx.reordered == 1);
+    assert(rx.accept(15, 40));
+    SeqTracker wrap;
+    assert(wrap.accept(0xFFFF, 0) && wrap.accept(0, 10) && wrap.lost == 0);
+
+    // A sender restart resyncs instead of dropping frames until seq catches up
+    SeqTracker restart;
+    for (uint16_t s = 0; s <= 500; ++s) assert(restart.accept(s, s));
+    assert(restart.accept(0, 501) && restart.resyncs == 1);
+    assert(restart.accept(1, 502) && restart.lost == 0 && restart.reordered == 0);
+    // A restart close to the old sequence is caught by the silence while rebooting
+    SeqTracker early;
+    for (uint16_t s = 0; s <= 20; ++s) assert(early.accept(s, s));
+    assert(!early.accept(5, 30) && early.reordered == 1);   // still just reordered
+    assert(early.accept(0, 30 + SeqTracker::RESYNC_IDLE_MS) && early.resyncs == 1);
+    assert(early.accept(1, 1031) && early.lost == 0 && early.reordered == 1);
+    // A pause in playing is not a restart: the next frame continues the sequence
+    SeqTracker pause;
+    assert(pause.accept(40, 0) && pause.accept(41, 10));
+    assert(pause.accept(42, 10 + 5 * SeqTracker::RESYNC_IDLE_MS) && pause.resyncs == 0 && pause.lost == 0);
+    // and frames lost around it are still counted
+    assert(pause.accept(45, 20 + 10 * SeqTracker::RESYNC_IDLE_MS) && pause.resyncs == 0 && pause.lost == 2);
+
+    std::cout << "Test wire_protocol passed\n";
+    return 0;
+}